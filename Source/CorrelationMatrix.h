@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    CorrelationMatrix.h
+    Created: 17 Oct 2026 12:58:55pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Correlation between every pair of channels of a multichannel bus, using
+// the same 32-sample hops and exponential integration as CorrelationMeter.
+// Each hop is reduced while all channels' segments are still in cache; the
+// per-channel energies are computed once and shared by every pair they take
+// part in, so the cost is C energies + C(C-1)/2 cross products per sample.
+// Nothing is computed until something that shows the matrix enables it.
+class CorrelationMatrix
+{
+public:
+    static constexpr int maxChannels = 16;
+    static constexpr int maxPairs = maxChannels * (maxChannels - 1) / 2;
+
+    void prepare(double sampleRate, float integrationTimeMs = 300.0f)
+    {
+        double hopSeconds = hopSize / sampleRate;
+        decay = std::exp(-hopSeconds / juce::jmax(1.0e-3, integrationTimeMs * 0.001));
+        reset();
+    }
+
+    void reset()
+    {
+        energies.fill(0.0);
+        crosses.fill(0.0);
+        pendingEnergies.fill(0.0f);
+        pendingCrosses.fill(0.0f);
+        pendingCount = 0;
+
+        for (auto& value : correlations)
+            value.store(0.0f, std::memory_order_relaxed);
+    }
+
+    // Any thread. Switching it back on starts the integration from zero.
+    void setEnabled(bool shouldBeEnabled) { enabled.store(shouldBeEnabled); }
+    bool isEnabled() const { return enabled.load(); }
+
+    template <typename SampleType>
+    void process(const SampleType* const* channels, int numChannels, int numSamples)
+    {
+        if (! enabled.load(std::memory_order_relaxed))
+        {
+            running = false;
+            return;
+        }
+
+        if (! running)
+        {
+            reset();
+            running = true;
+        }
+
+        numChannels = juce::jmin(numChannels, maxChannels);
+        int offset = 0;
+
+        while (offset < numSamples)
+        {
+            int chunk = juce::jmin(numSamples - offset, hopSize - pendingCount);
+
+            for (int a = 0; a < numChannels; ++a)
+            {
+                const SampleType* x = channels[a] + offset;
+                pendingEnergies[(size_t) a] += dot(x, x, chunk);
+
+                for (int b = a + 1; b < numChannels; ++b)
+                    pendingCrosses[(size_t) getPairIndex(a, b)] += dot(x, channels[b] + offset, chunk);
+            }
+
+            offset += chunk;
+            pendingCount += chunk;
+
+            if (pendingCount == hopSize)
+                finishHop(numChannels);
+        }
+
+        publish(numChannels);
+    }
+
+    // Any thread. 1 on the diagonal.
+    float getCorrelation(int a, int b) const
+    {
+        if (a == b) return 1.0f;
+        if (a > b) std::swap(a, b);
+        if (! juce::isPositiveAndBelow(b, maxChannels) || a < 0) return 0.0f;
+
+        return correlations[(size_t) getPairIndex(a, b)].load(std::memory_order_relaxed);
+    }
+
+private:
+    // Upper triangle, row by row
+    static constexpr int getPairIndex(int a, int b)
+    {
+        return a * (2 * maxChannels - a - 1) / 2 + (b - a - 1);
+    }
+
+    template <typename SampleType>
+    static float dot(const SampleType* x, const SampleType* y, int numSamples)
+    {
+        constexpr int lanes = 8;
+        SampleType acc[lanes] = {};
+
+        int i = 0;
+        for (; i + lanes <= numSamples; i += lanes)
+            for (int k = 0; k < lanes; ++k)
+                acc[k] += x[i + k] * y[i + k];
+
+        for (int k = 0; i < numSamples; ++i, ++k)
+            acc[k] += x[i] * y[i];
+
+        return static_cast<float>(((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7])));
+    }
+
+    void finishHop(int numChannels)
+    {
+        for (int a = 0; a < numChannels; ++a)
+        {
+            energies[(size_t) a] = decay * energies[(size_t) a] + (1.0 - decay) * pendingEnergies[(size_t) a];
+
+            for (int b = a + 1; b < numChannels; ++b)
+            {
+                auto p = (size_t) getPairIndex(a, b);
+                crosses[p] = decay * crosses[p] + (1.0 - decay) * pendingCrosses[p];
+            }
+        }
+
+        pendingEnergies.fill(0.0f);
+        pendingCrosses.fill(0.0f);
+        pendingCount = 0;
+    }
+
+    void publish(int numChannels)
+    {
+        for (int a = 0; a < numChannels; ++a)
+        {
+            for (int b = a + 1; b < numChannels; ++b)
+            {
+                auto p = (size_t) getPairIndex(a, b);
+                double denom = std::sqrt(energies[(size_t) a] * energies[(size_t) b]);
+                float value = denom > 0.0 ? static_cast<float>(juce::jlimit(-1.0, 1.0, crosses[p] / denom)) : 0.0f;
+                correlations[p].store(value, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static constexpr int hopSize = 32;
+
+    double decay = 0.0;
+
+    std::array<double, maxChannels> energies {};
+    std::array<double, maxPairs> crosses {};
+    std::array<float, maxChannels> pendingEnergies {};
+    std::array<float, maxPairs> pendingCrosses {};
+    int pendingCount = 0;
+    bool running = false;
+
+    std::atomic<bool> enabled { false };
+    std::array<std::atomic<float>, maxPairs> correlations {};
+};
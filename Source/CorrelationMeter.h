@@ -0,0 +1,396 @@
+/*
+  ==============================================================================
+
+    CorrelationMeter.h
+    Created: 17 Oct 2026 12:52:26pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Stereo correlation with fixed integration times, independent of the host's
+// block size. Products are reduced over fixed 32-sample hops (carried across
+// blocks) and each hop updates exponentially-weighted running sums, so a fast
+// and a slow reading plus an integrated one come out of the same pass.
+//
+// The same pass also K-weights both channels for loudness (ITU-R BS.1770:
+// momentary, short-term and gated integrated) and oversamples them 4x for
+// true-peak, so the buffer is only walked once for every reading here.
+class CorrelationMeter
+{
+public:
+    enum Speed { fast = 0, slow, numSpeeds };
+
+    // Reported for silence, and by loudness readings that have no data yet
+    static constexpr float minimumLevel = -100.0f;
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        setIntegrationTime(fast, integrationTimesMs[fast]);
+        setIntegrationTime(slow, integrationTimesMs[slow]);
+        prepareKWeighting();
+        loudnessStepLength = juce::jmax(1, juce::roundToInt(0.1 * sampleRate));
+        reset();
+    }
+
+    // Time constant of one reading in milliseconds
+    void setIntegrationTime(Speed speed, float milliseconds)
+    {
+        integrationTimesMs[speed] = milliseconds;
+        double hopSeconds = hopSize / sampleRate;
+        decay[speed] = std::exp(-hopSeconds / juce::jmax(1.0e-3, milliseconds * 0.001));
+    }
+
+    void reset()
+    {
+        for (auto& s : running)
+            s = {};
+
+        integrated = {};
+        pending = {};
+        pendingCount = 0;
+
+        kWeightingState = {};
+        peakHistory = {};
+        peakWrite = 0;
+        resetLoudness();
+    }
+
+    // Starts the integrated loudness and the true-peak hold over
+    void resetLoudness()
+    {
+        stepPowers = {};
+        stepEnergy = 0.0;
+        stepCount = stepIndex = numSteps = 0;
+
+        gatingCounts = {};
+        gatingPowers = {};
+
+        momentary = shortTerm = integratedLoudness = minimumLevel;
+        truePeak = { 0.0f, 0.0f };
+    }
+
+    template <typename SampleType>
+    void process(const SampleType* left, const SampleType* right, int numSamples)
+    {
+        while (numSamples > 0)
+        {
+            // Chunks end on hop and on 100 ms loudness boundaries, so neither
+            // needs checking per sample
+            int chunk = juce::jmin(numSamples, hopSize - pendingCount, loudnessStepLength - stepCount);
+            analyse(left, right, chunk);
+            pendingCount += chunk;
+            stepCount += chunk;
+
+            left += chunk;
+            right += chunk;
+            numSamples -= chunk;
+
+            if (pendingCount == hopSize)
+            {
+                for (int speed = 0; speed < numSpeeds; ++speed)
+                    running[speed].decayTowards(pending, decay[speed]);
+
+                integrated += pending;
+                pending = {};
+                pendingCount = 0;
+            }
+
+            if (stepCount == loudnessStepLength)
+                finishLoudnessStep();
+        }
+    }
+
+    float getCorrelation(Speed speed) const { return running[speed].correlation(); }
+    float getIntegratedCorrelation() const   { return integrated.correlation(); }
+
+    // LUFS over the last 400 ms, the last 3 s, and gated since the last reset
+    float getMomentaryLoudness() const  { return momentary; }
+    float getShortTermLoudness() const  { return shortTerm; }
+    float getIntegratedLoudness() const { return integratedLoudness; }
+
+    // Highest 4x oversampled peak since the last reset, in dBTP
+    float getTruePeak(int channel) const { return juce::Decibels::gainToDecibels(truePeak[(size_t) channel], minimumLevel); }
+
+    // Mid over side energy in dB with the slow time constant: +60 for mono,
+    // around 0 for uncorrelated channels, negative when mostly out of phase
+    float getMidSideRatio() const
+    {
+        const auto& s = running[slow];
+        const double mid = s.ll + s.rr + 2.0 * s.lr;
+        const double side = s.ll + s.rr - 2.0 * s.lr;
+
+        if (mid <= 0.0 && side <= 0.0)
+            return 0.0f;
+
+        return static_cast<float>(juce::jlimit(-60.0, 60.0, 10.0 * std::log10(juce::jmax(mid, 1.0e-12) / juce::jmax(side, 1.0e-12))));
+    }
+
+private:
+    struct Sums
+    {
+        double ll = 0.0, rr = 0.0, lr = 0.0;
+
+        Sums& operator+= (const Sums& other)
+        {
+            ll += other.ll;
+            rr += other.rr;
+            lr += other.lr;
+            return *this;
+        }
+
+        void decayTowards(const Sums& hop, double a)
+        {
+            ll = a * ll + (1.0 - a) * hop.ll;
+            rr = a * rr + (1.0 - a) * hop.rr;
+            lr = a * lr + (1.0 - a) * hop.lr;
+        }
+
+        float correlation() const
+        {
+            double denom = std::sqrt(ll * rr);
+            if (denom <= 0.0) return 0.0f;
+
+            return static_cast<float>(juce::jlimit(-1.0, 1.0, lr / denom));
+        }
+    };
+
+    // Second-order section, transposed direct form II
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    // The two K-weighting stages from BS.1770, re-derived for the sample rate
+    // (the standard only lists 48 kHz coefficients)
+    void prepareKWeighting()
+    {
+        const double pi = juce::MathConstants<double>::pi;
+
+        // High shelf, about +4 dB above 1.5 kHz
+        {
+            const double k = std::tan(pi * 1681.974450955533 / sampleRate);
+            const double q = 0.7071752369554196;
+            const double vh = std::pow(10.0, 3.999843853973347 / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+
+            shelf = { (vh + vb * k / q + k * k) / a0,
+                      2.0 * (k * k - vh) / a0,
+                      (vh - vb * k / q + k * k) / a0,
+                      2.0 * (k * k - 1.0) / a0,
+                      (1.0 - k / q + k * k) / a0 };
+        }
+
+        // RLB high-pass at 38 Hz
+        {
+            const double k = std::tan(pi * 38.13547087602444 / sampleRate);
+            const double q = 0.5003270373238773;
+            const double a0 = 1.0 + k / q + k * k;
+
+            highPass = { 1.0, -2.0, 1.0,
+                         2.0 * (k * k - 1.0) / a0,
+                         (1.0 - k / q + k * k) / a0 };
+        }
+    }
+
+    double kWeight(int channel, double x)
+    {
+        auto& z = kWeightingState[(size_t) channel];
+
+        const double y = shelf.b0 * x + z[0];
+        z[0] = shelf.b1 * x - shelf.a1 * y + z[1];
+        z[1] = shelf.b2 * x - shelf.a2 * y;
+
+        const double w = highPass.b0 * y + z[2];
+        z[2] = highPass.b1 * y - highPass.a1 * w + z[3];
+        z[3] = highPass.b2 * y - highPass.a2 * w;
+
+        return w;
+    }
+
+    // The whole per-sample pass. The correlation products keep eight
+    // independent partial sums each so they don't form a serial dependency
+    // chain, and are accumulated at the input's precision. The K-weighting
+    // filters run in double, the true-peak interpolator in float.
+    template <typename SampleType>
+    void analyse(const SampleType* left, const SampleType* right, int numSamples)
+    {
+        constexpr int lanes = 8;
+        SampleType ll[lanes] = {}, rr[lanes] = {}, lr[lanes] = {};
+        double weighted = 0.0;
+        float peaks[2 * truePeakPhases] = {};
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const SampleType l = left[i];
+            const SampleType r = right[i];
+            const int k = i & (lanes - 1);
+
+            ll[k] += l * l;
+            rr[k] += r * r;
+            lr[k] += l * r;
+
+            const double kl = kWeight(0, static_cast<double>(l));
+            const double kr = kWeight(1, static_cast<double>(r));
+            weighted += kl * kl + kr * kr;
+
+            // Polyphase 4x interpolation: every phase of both channels is one
+            // lane, so each tap is a single 8-wide multiply-add
+            peakWrite = peakWrite == truePeakTaps - 1 ? 0 : peakWrite + 1;
+            peakHistory[0][(size_t) peakWrite] = peakHistory[0][(size_t) (peakWrite + truePeakTaps)] = static_cast<float>(l);
+            peakHistory[1][(size_t) peakWrite] = peakHistory[1][(size_t) (peakWrite + truePeakTaps)] = static_cast<float>(r);
+
+            const float* historyL = peakHistory[0].data() + peakWrite + 1;
+            const float* historyR = peakHistory[1].data() + peakWrite + 1;
+            float y[2 * truePeakPhases] = {};
+
+            for (int tap = 0; tap < truePeakTaps; ++tap)
+            {
+                for (int phase = 0; phase < truePeakPhases; ++phase)
+                {
+                    y[phase]                  += truePeakCoefficients[tap][phase] * historyL[tap];
+                    y[phase + truePeakPhases] += truePeakCoefficients[tap][phase] * historyR[tap];
+                }
+            }
+
+            for (int lane = 0; lane < 2 * truePeakPhases; ++lane)
+                peaks[lane] = juce::jmax(peaks[lane], std::abs(y[lane]));
+        }
+
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            pending.ll += ll[lane];
+            pending.rr += rr[lane];
+            pending.lr += lr[lane];
+        }
+
+        stepEnergy += weighted;
+
+        for (int phase = 0; phase < truePeakPhases; ++phase)
+        {
+            truePeak[0] = juce::jmax(truePeak[0], peaks[phase]);
+            truePeak[1] = juce::jmax(truePeak[1], peaks[phase + truePeakPhases]);
+        }
+    }
+
+    static float toLoudness(double power)
+    {
+        return power > 0.0 ? juce::jmax(minimumLevel, static_cast<float>(-0.691 + 10.0 * std::log10(power)))
+                           : minimumLevel;
+    }
+
+    // Every 100 ms: the momentary and short-term windows slide by one step,
+    // and the 400 ms block ending here goes into the gating histogram
+    void finishLoudnessStep()
+    {
+        stepPowers[(size_t) stepIndex] = stepEnergy / loudnessStepLength;
+        stepIndex = (stepIndex + 1) % shortTermSteps;
+        numSteps = juce::jmin(numSteps + 1, shortTermSteps);
+        stepEnergy = 0.0;
+        stepCount = 0;
+
+        auto meanOfLast = [this](int count)
+        {
+            double sum = 0.0;
+            for (int i = 1; i <= count; ++i)
+                sum += stepPowers[(size_t) ((stepIndex - i + shortTermSteps) % shortTermSteps)];
+            return sum / count;
+        };
+
+        const double blockPower = meanOfLast(juce::jmin(numSteps, momentarySteps));
+        momentary = toLoudness(blockPower);
+        shortTerm = toLoudness(meanOfLast(numSteps));
+
+        // Absolute gate at -70 LUFS; only whole 400 ms blocks count
+        if (numSteps < momentarySteps || momentary <= gateFloor)
+            return;
+
+        const int bin = juce::jlimit(0, numGatingBins - 1, static_cast<int>((momentary - gateFloor) * binsPerLU));
+        ++gatingCounts[(size_t) bin];
+        gatingPowers[(size_t) bin] += blockPower;
+
+        integratedLoudness = gatedLoudness();
+    }
+
+    // Relative gate 10 LU below the mean of the blocks above the absolute
+    // gate. Blocks are binned at 0.1 LU, so this is a fixed cost however long
+    // the integration runs.
+    float gatedLoudness() const
+    {
+        auto meanFrom = [this](int firstBin)
+        {
+            double power = 0.0, count = 0.0;
+            for (int bin = firstBin; bin < numGatingBins; ++bin)
+            {
+                power += gatingPowers[(size_t) bin];
+                count += static_cast<double>(gatingCounts[(size_t) bin]);
+            }
+            return count > 0.0 ? power / count : 0.0;
+        };
+
+        const float relativeGate = toLoudness(meanFrom(0)) - 10.0f;
+        const int firstBin = juce::jlimit(0, numGatingBins - 1, static_cast<int>(std::ceil((relativeGate - gateFloor) * binsPerLU)));
+
+        return toLoudness(meanFrom(firstBin));
+    }
+
+    static constexpr int hopSize = 32;
+
+    double sampleRate = 44100.0;
+    float integrationTimesMs[numSpeeds] = { 50.0f, 300.0f };
+    double decay[numSpeeds] = {};
+
+    Sums running[numSpeeds];
+    Sums integrated;
+    Sums pending;
+    int pendingCount = 0;
+
+    // K-weighting: shared coefficients, state per channel
+    Biquad shelf, highPass;
+    std::array<std::array<double, 4>, 2> kWeightingState {};
+
+    // Loudness in 100 ms steps of K-weighted mean square, summed over both channels
+    static constexpr int momentarySteps = 4, shortTermSteps = 30;
+    std::array<double, shortTermSteps> stepPowers {};
+    double stepEnergy = 0.0;
+    int loudnessStepLength = 4410, stepCount = 0, stepIndex = 0, numSteps = 0;
+
+    // Integrated loudness: gated 400 ms blocks, -70 to +10 LUFS in 0.1 LU bins
+    static constexpr float gateFloor = -70.0f, binsPerLU = 10.0f;
+    static constexpr int numGatingBins = 800;
+    std::array<juce::uint32, numGatingBins> gatingCounts {};
+    std::array<double, numGatingBins> gatingPowers {};
+
+    float momentary = minimumLevel, shortTerm = minimumLevel, integratedLoudness = minimumLevel;
+
+    // True-peak: the 48-tap interpolator from BS.1770 Annex 2, stored tap by
+    // tap with the four phases side by side. The history is written twice so
+    // the newest 12 samples are always contiguous, oldest first. Applied in
+    // that order each phase runs time-reversed, but phases 0/3 and 1/2 are
+    // mirror images of each other, so the same four outputs come out.
+    static constexpr int truePeakTaps = 12, truePeakPhases = 4;
+    static constexpr float truePeakCoefficients[truePeakTaps][truePeakPhases] =
+    {
+        {  0.0017089843750f, -0.0291748046875f, -0.0189208984375f, -0.0083007812500f },
+        {  0.0109863281250f,  0.0292968750000f,  0.0330810546875f,  0.0148925781250f },
+        { -0.0196533203125f, -0.0517578125000f, -0.0582275390625f, -0.0266113281250f },
+        {  0.0332031250000f,  0.0891113281250f,  0.1015625000000f,  0.0476074218750f },
+        { -0.0594482421875f, -0.1665039062500f, -0.2003173828125f, -0.1022949218750f },
+        {  0.1373291015625f,  0.4650878906250f,  0.7797851562500f,  0.9721679687500f },
+        {  0.9721679687500f,  0.7797851562500f,  0.4650878906250f,  0.1373291015625f },
+        { -0.1022949218750f, -0.2003173828125f, -0.1665039062500f, -0.0594482421875f },
+        {  0.0476074218750f,  0.1015625000000f,  0.0891113281250f,  0.0332031250000f },
+        { -0.0266113281250f, -0.0582275390625f, -0.0517578125000f, -0.0196533203125f },
+        {  0.0148925781250f,  0.0330810546875f,  0.0292968750000f,  0.0109863281250f },
+        { -0.0083007812500f, -0.0189208984375f, -0.0291748046875f,  0.0017089843750f }
+    };
+
+    std::array<std::array<float, 2 * truePeakTaps>, 2> peakHistory {};
+    int peakWrite = 0;
+    std::array<float, 2> truePeak {};
+};
@@ -0,0 +1,353 @@
+/*
+  ==============================================================================
+
+    MultibandWidth.h
+    Created: 17 Oct 2026 1:03:16pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Splits mid and side into up to four Linkwitz-Riley (LR4) bands and gives
+// each band its own width, so e.g. the low end can be kept mono.
+//
+// The bands are built in parallel rather than as a tree. With crossovers
+// f1 < f2 < f3, band j is the high-pass of every crossover below it, the
+// low-pass of the one directly above it and the LR4 all-pass of the rest:
+//
+//     band 0 = LP1 . AP2 . AP3        band 2 = HP1 . HP2 . LP3
+//     band 1 = HP1 . LP2 . AP3        band 3 = HP1 . HP2 . HP3
+//
+// so the bands sum to AP1 . AP2 . AP3 and are phase-aligned. Every band is at
+// most six biquads deep, which gives eight lanes (4 bands x mid/side) of six
+// stages; the coefficients and states are stored structure-of-arrays so one
+// stage of all lanes is a single vector operation, and every band is
+// filtered in the same pass over the buffer. Float and double buffers each
+// have their own lanes, so the double path never goes through float.
+class MultibandWidth
+{
+public:
+    static constexpr int maxBands = 4;
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        appliedBands = 0; // Forces a coefficient update on the next block
+        reset();
+
+        for (int band = 0; band < maxBands; ++band)
+        {
+            currentWidths[band] = targetWidths[band];
+            bandEnergies[band] = {};
+            bandCorrelations[band].store(0.0f, std::memory_order_relaxed);
+        }
+    }
+
+    void reset()
+    {
+        floatLanes.reset();
+        doubleLanes.reset();
+    }
+
+    // One band disables the split altogether. Crossovers are kept in
+    // ascending order, and at least a third of an octave apart. Each one is
+    // also capped low enough to leave that spacing for the active crossovers
+    // above it, so the top one never passes 0.45 fs, where the sections
+    // would turn unstable.
+    void setParameters(int numBands, const float* crossoverFrequencies, const float* widthPercents)
+    {
+        targetBands = juce::jlimit(1, maxBands, numBands);
+
+        const int numCrossovers = targetBands - 1;
+        const float highest = static_cast<float>(sampleRate * 0.45);
+        float lowest = 20.0f;
+
+        for (int i = 0; i < maxBands - 1; ++i)
+        {
+            const int above = juce::jmax(0, numCrossovers - 1 - i);
+            const float ceiling = highest / std::pow(1.26f, static_cast<float>(above));
+
+            targetCrossovers[i] = juce::jmin(ceiling, juce::jmax(lowest, crossoverFrequencies[i]));
+            lowest = targetCrossovers[i] * 1.26f;
+        }
+
+        for (int band = 0; band < maxBands; ++band)
+            targetWidths[band] = widthPercents[band] * 0.01f;
+    }
+
+    // Filtering runs in the buffer's own precision: eight float lanes fill
+    // one AVX register, eight double lanes two
+    template <typename SampleType>
+    void process(SampleType* leftChannel, SampleType* rightChannel, int numSamples)
+    {
+        if (numSamples <= 0)
+            return;
+
+        if (targetBands != appliedBands || ! std::equal(std::begin(targetCrossovers), std::end(targetCrossovers), std::begin(appliedCrossovers)))
+            updateCoefficients();
+
+        if (appliedBands < 2)
+            return;
+
+        auto& lanes = getLanes<SampleType>();
+
+        // Widths are ramped linearly across the block
+        SampleType width[maxBands], widthStep[maxBands];
+        for (int band = 0; band < maxBands; ++band)
+        {
+            width[band] = static_cast<SampleType>(currentWidths[band]);
+            widthStep[band] = (static_cast<SampleType>(targetWidths[band]) - width[band]) / static_cast<SampleType>(numSamples);
+            currentWidths[band] = targetWidths[band];
+        }
+
+        SampleType mm[maxBands] = {}, ss[maxBands] = {}, ms[maxBands] = {};
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            alignas(32) SampleType x[numLanes];
+            const SampleType mid = (leftChannel[i] + rightChannel[i]) * SampleType(0.5);
+            const SampleType side = (leftChannel[i] - rightChannel[i]) * SampleType(0.5);
+
+            for (int lane = 0; lane < maxBands; ++lane)
+            {
+                x[lane] = mid;
+                x[lane + maxBands] = side;
+            }
+
+            // Transposed direct form II, one stage of all eight lanes at a time
+            for (int stage = 0; stage < numStages; ++stage)
+            {
+                for (int lane = 0; lane < numLanes; ++lane)
+                {
+                    const SampleType in = x[lane];
+                    const SampleType out = lanes.b0[stage][lane] * in + lanes.z1[stage][lane];
+                    lanes.z1[stage][lane] = lanes.b1[stage][lane] * in - lanes.a1[stage][lane] * out + lanes.z2[stage][lane];
+                    lanes.z2[stage][lane] = lanes.b2[stage][lane] * in - lanes.a2[stage][lane] * out;
+                    x[lane] = out;
+                }
+            }
+
+            SampleType midOut = 0, sideOut = 0;
+            const SampleType t = static_cast<SampleType>(i + 1);
+
+            for (int band = 0; band < maxBands; ++band)
+            {
+                const SampleType m = x[band];
+                const SampleType s = x[band + maxBands];
+
+                midOut += m;
+                sideOut += s * (width[band] + widthStep[band] * t);
+
+                mm[band] += m * m;
+                ss[band] += s * s;
+                ms[band] += m * s;
+            }
+
+            leftChannel[i] = midOut + sideOut;
+            rightChannel[i] = midOut - sideOut;
+        }
+
+        // A non-finite input would stay in the recursive states for good. The
+        // states are checked once per block, and the bands start again from
+        // silence.
+        if (! lanes.isFinite())
+        {
+            reset();
+
+            for (auto& e : bandEnergies)
+                e = {};
+
+            return;
+        }
+
+        updateCorrelations(mm, ss, ms, numSamples);
+    }
+
+    // Per-band L/R correlation (300 ms), readable from any thread
+    float getBandCorrelation(int band) const
+    {
+        return bandCorrelations[(size_t) juce::jlimit(0, maxBands - 1, band)].load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int numStages = 6;
+    static constexpr int numLanes = 2 * maxBands;
+
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    // Coefficients and states of every stage and lane, structure-of-arrays
+    template <typename SampleType>
+    struct Lanes
+    {
+        alignas(32) SampleType b0[numStages][numLanes] {}, b1[numStages][numLanes] {}, b2[numStages][numLanes] {};
+        alignas(32) SampleType a1[numStages][numLanes] {}, a2[numStages][numLanes] {};
+        alignas(32) SampleType z1[numStages][numLanes] {}, z2[numStages][numLanes] {};
+
+        void reset()
+        {
+            for (int stage = 0; stage < numStages; ++stage)
+            {
+                std::fill(std::begin(z1[stage]), std::end(z1[stage]), SampleType(0));
+                std::fill(std::begin(z2[stage]), std::end(z2[stage]), SampleType(0));
+            }
+        }
+
+        void setStage(int stage, int band, const Biquad& q)
+        {
+            for (int lane : { band, band + maxBands })
+            {
+                b0[stage][lane] = static_cast<SampleType>(q.b0);
+                b1[stage][lane] = static_cast<SampleType>(q.b1);
+                b2[stage][lane] = static_cast<SampleType>(q.b2);
+                a1[stage][lane] = static_cast<SampleType>(q.a1);
+                a2[stage][lane] = static_cast<SampleType>(q.a2);
+            }
+        }
+
+        // Looks for an all-ones exponent in the states' bits, which
+        // -ffast-math and /fp:fast can't fold away as they may std::isfinite
+        bool isFinite() const
+        {
+            using Bits = std::conditional_t<sizeof(SampleType) == 4, juce::uint32, juce::uint64>;
+            constexpr Bits exponent = sizeof(SampleType) == 4 ? Bits(0x7f800000u) : Bits(0x7ff0000000000000ull);
+
+            Bits bits[2][numStages][numLanes];
+            std::memcpy(bits[0], z1, sizeof(z1));
+            std::memcpy(bits[1], z2, sizeof(z2));
+
+            bool bad = false;
+            for (const auto& state : bits)
+                for (const auto& stage : state)
+                    for (auto b : stage)
+                        bad |= (b & exponent) == exponent;
+
+            return ! bad;
+        }
+    };
+
+    template <typename SampleType>
+    Lanes<SampleType>& getLanes()
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+            return floatLanes;
+        else
+            return doubleLanes;
+    }
+
+    enum class Response { lowPass, highPass, allPass };
+
+    // Butterworth (Q = 1/sqrt 2) sections; two of them make an LR4 low or
+    // high pass, one all-pass section is the LR4 sum.
+    Biquad design(Response response, float frequency) const
+    {
+        const double w0 = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        const double cosW = std::cos(w0);
+        const double alpha = std::sin(w0) / juce::MathConstants<double>::sqrt2;
+        const double a0 = 1.0 + alpha;
+
+        double b0, b1, b2;
+        switch (response)
+        {
+            case Response::lowPass:  b0 = (1.0 - cosW) * 0.5;  b1 = 1.0 - cosW;    b2 = b0;          break;
+            case Response::highPass: b0 = (1.0 + cosW) * 0.5;  b1 = -(1.0 + cosW); b2 = b0;          break;
+            case Response::allPass:
+            default:                 b0 = 1.0 - alpha;         b1 = -2.0 * cosW;   b2 = 1.0 + alpha; break;
+        }
+
+        return { b0 / a0, b1 / a0, b2 / a0, -2.0 * cosW / a0, (1.0 - alpha) / a0 };
+    }
+
+    // Both precisions are kept up to date, so a change of processing
+    // precision doesn't need new coefficients
+    void setStage(int stage, int band, const Biquad& q)
+    {
+        floatLanes.setStage(stage, band, q);
+        doubleLanes.setStage(stage, band, q);
+    }
+
+    void updateCoefficients()
+    {
+        // A different number of bands means a different topology, so start clean
+        if (targetBands != appliedBands)
+            reset();
+
+        appliedBands = targetBands;
+        std::copy(std::begin(targetCrossovers), std::end(targetCrossovers), std::begin(appliedCrossovers));
+
+        for (int band = 0; band < maxBands; ++band)
+        {
+            int stage = 0;
+
+            if (band < appliedBands)
+            {
+                for (int crossover = 0; crossover < appliedBands - 1; ++crossover)
+                {
+                    const float f = appliedCrossovers[crossover];
+
+                    if (crossover < band)
+                    {
+                        setStage(stage++, band, design(Response::highPass, f));
+                        setStage(stage++, band, design(Response::highPass, f));
+                    }
+                    else if (crossover == band)
+                    {
+                        setStage(stage++, band, design(Response::lowPass, f));
+                        setStage(stage++, band, design(Response::lowPass, f));
+                    }
+                    else
+                    {
+                        setStage(stage++, band, design(Response::allPass, f));
+                    }
+                }
+            }
+            else
+            {
+                setStage(stage++, band, { 0.0, 0.0, 0.0, 0.0, 0.0 }); // Unused band: silent lane
+            }
+
+            while (stage < numStages)
+                setStage(stage++, band, {});
+        }
+    }
+
+    template <typename SampleType>
+    void updateCorrelations(const SampleType* mm, const SampleType* ss, const SampleType* ms, int numSamples)
+    {
+        // Same 300 ms integration as the broadband meter, scaled to this block's length
+        const double a = std::exp(-numSamples / (0.3 * sampleRate));
+
+        for (int band = 0; band < appliedBands; ++band)
+        {
+            auto& e = bandEnergies[band];
+            e.mm = a * e.mm + (1.0 - a) * mm[band];
+            e.ss = a * e.ss + (1.0 - a) * ss[band];
+            e.ms = a * e.ms + (1.0 - a) * ms[band];
+
+            // With L = M + S and R = M - S:  <LR> = <MM> - <SS>,  <LL><RR> = (<MM> + <SS>)^2 - 4<MS>^2
+            const double denom = std::sqrt(juce::jmax(0.0, juce::square(e.mm + e.ss) - 4.0 * e.ms * e.ms));
+            const float correlation = denom > 0.0 ? static_cast<float>(juce::jlimit(-1.0, 1.0, (e.mm - e.ss) / denom)) : 0.0f;
+            bandCorrelations[(size_t) band].store(correlation, std::memory_order_relaxed);
+        }
+    }
+
+    double sampleRate = 44100.0;
+
+    int targetBands = 1, appliedBands = 0;
+    float targetCrossovers[maxBands - 1] = { 120.0f, 1000.0f, 6000.0f };
+    float appliedCrossovers[maxBands - 1] = {};
+    float targetWidths[maxBands] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float currentWidths[maxBands] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+    Lanes<float> floatLanes;
+    Lanes<double> doubleLanes;
+
+    struct Energies { double mm = 0.0, ss = 0.0, ms = 0.0; };
+    Energies bandEnergies[maxBands];
+    std::array<std::atomic<float>, maxBands> bandCorrelations {};
+};
@@ -0,0 +1,223 @@
+/*
+  ==============================================================================
+
+    ParameterSnapshots.cpp
+    Created: 17 Oct 2026 1:09:11pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#include "ParameterSnapshots.h"
+
+ParameterSnapshots::ParameterSnapshots(juce::AudioProcessorValueTreeState& state)
+: apvts(state)
+{
+    for (auto* parameter : apvts.processor.getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+        {
+            parameters.push_back(ranged);
+            liveValues.push_back(apvts.getRawParameterValue(ranged->getParameterID()));
+        }
+    }
+
+    jassert(parameters.size() <= (size_t) maxParameters);
+}
+
+//==============================================================================
+void ParameterSnapshots::store(int slot)
+{
+    const auto values = readLive();
+
+    const juce::ScopedLock sl(slotLock);
+    auto& s = slots[(size_t) slot];
+    s.values = values;
+    s.stored = true;
+    currentSlot = slot;
+}
+
+void ParameterSnapshots::recall(int slot)
+{
+    Values values;
+
+    {
+        const juce::ScopedLock sl(slotLock);
+        const auto& s = slots[(size_t) slot];
+        if (! s.stored)
+            return;
+
+        values = s.values;
+        currentSlot = slot;
+
+        // The audio thread gets the whole set at once; if it isn't running the
+        // queue may be full, and the parameters below are all that matters
+        if (queue.getFreeSpace() > 0)
+        {
+            const auto scope = queue.write(1);
+            queuedValues[(size_t) (scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = values;
+        }
+    }
+
+    // ...and the host and the editor see the parameters change as usual.
+    // The lock is released first, as the host may save state in response.
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        auto* parameter = parameters[i];
+        parameter->beginChangeGesture();
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(values[i]));
+        parameter->endChangeGesture();
+    }
+}
+
+bool ParameterSnapshots::hasSnapshot(int slot) const
+{
+    const juce::ScopedLock sl(slotLock);
+    return slots[(size_t) slot].stored;
+}
+
+int ParameterSnapshots::getCurrentSlot() const
+{
+    const juce::ScopedLock sl(slotLock);
+    return currentSlot;
+}
+
+juce::ValueTree ParameterSnapshots::toValueTree() const
+{
+    std::array<Slot, numSlots> slotsCopy;
+    int current;
+
+    {
+        const juce::ScopedLock sl(slotLock);
+        slotsCopy = slots;
+        current = currentSlot;
+    }
+
+    juce::ValueTree tree("Snapshots");
+    tree.setProperty("current", current, nullptr);
+
+    for (int slot = 0; slot < numSlots; ++slot)
+    {
+        const auto& s = slotsCopy[(size_t) slot];
+        if (! s.stored)
+            continue;
+
+        juce::ValueTree child("Slot");
+        child.setProperty("index", slot, nullptr);
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+            child.setProperty(parameters[i]->getParameterID(), s.values[i], nullptr);
+
+        tree.appendChild(child, nullptr);
+    }
+
+    return tree;
+}
+
+void ParameterSnapshots::fromValueTree(const juce::ValueTree& tree)
+{
+    // Built aside and swapped in, so the lock isn't held while parsing
+    std::array<Slot, numSlots> newSlots {};
+    int current = -1;
+
+    if (tree.hasType("Snapshots"))
+    {
+        for (const auto& child : tree)
+        {
+            const int slot = child.getProperty("index", -1);
+            if (! juce::isPositiveAndBelow(slot, numSlots))
+                continue;
+
+            // Parameters the snapshot doesn't know about get their defaults
+            auto& s = newSlots[(size_t) slot];
+            for (size_t i = 0; i < parameters.size(); ++i)
+            {
+                auto* parameter = parameters[i];
+                s.values[i] = child.getProperty(parameter->getParameterID(), parameter->convertFrom0to1(parameter->getDefaultValue()));
+            }
+
+            s.stored = true;
+        }
+
+        current = juce::jlimit(-1, numSlots - 1, static_cast<int>(tree.getProperty("current", -1)));
+    }
+
+    const juce::ScopedLock sl(slotLock);
+    slots = newSlots;
+    currentSlot = current;
+}
+
+//==============================================================================
+void ParameterSnapshots::prepare(double sampleRate)
+{
+    // Anything still queued was recalled while we weren't processing, and the
+    // parameters have been set since
+    queue.read(queue.getNumReady());
+
+    fade = Fade::none;
+    gain = 1.0f;
+    gainStep = static_cast<float>(1.0 / (0.005 * sampleRate)); // 5 ms each way
+    overriding = pending = jumped = false;
+    overrideTimeout = static_cast<int>(0.25 * sampleRate);
+    blockValues = readLive();
+}
+
+const ParameterSnapshots::Values& ParameterSnapshots::beginBlock()
+{
+    jumped = false;
+
+    // Only the newest recalled set matters
+    if (const int numReady = queue.getNumReady(); numReady > 0)
+    {
+        const auto scope = queue.read(numReady);
+        const int newest = scope.blockSize2 > 0 ? scope.startIndex2 + scope.blockSize2 - 1
+                                                : scope.startIndex1 + scope.blockSize1 - 1;
+        pendingValues = queuedValues[(size_t) newest];
+        pending = true;
+        fade = Fade::out;
+    }
+
+    // Silent: switch the whole set at once
+    if (pending && fade == Fade::out && gain <= 0.0f)
+    {
+        overrideValues = pendingValues;
+        overrideSamplesLeft = overrideTimeout;
+        overriding = true;
+        pending = false;
+        jumped = true;
+        fade = Fade::in;
+    }
+
+    // Still fading out: the live values are already on their way to the
+    // recalled set, so keep processing with the set from before the recall
+    if (pending)
+        return blockValues;
+
+    blockValues = readLive();
+
+    if (overriding)
+    {
+        // Hand back to the live values once they have all arrived, or after a
+        // timeout in case the host has moved one of them in the meantime
+        bool caughtUp = true;
+        for (size_t i = 0; i < liveValues.size() && caughtUp; ++i)
+            caughtUp = std::abs(blockValues[i] - overrideValues[i]) <= 1.0e-3f * juce::jmax(1.0f, std::abs(overrideValues[i]));
+
+        if (caughtUp || overrideSamplesLeft <= 0)
+            overriding = false;
+        else
+            blockValues = overrideValues;
+    }
+
+    return blockValues;
+}
+
+ParameterSnapshots::Values ParameterSnapshots::readLive() const
+{
+    Values values {};
+
+    for (size_t i = 0; i < liveValues.size(); ++i)
+        values[i] = liveValues[i]->load(std::memory_order_relaxed);
+
+    return values;
+}
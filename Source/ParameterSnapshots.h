@@ -0,0 +1,123 @@
+/*
+  ==============================================================================
+
+    ParameterSnapshots.h
+    Created: 17 Oct 2026 1:09:11pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// A/B snapshots of every parameter, and the hand-over of a recalled set to
+// the audio thread.
+//
+// Recalling a snapshot sets the host-visible parameters one by one, so for a
+// block or two the audio thread could see a mix of old and new values. To
+// avoid that the complete set is also queued to the audio thread, which dips
+// the output to silence on the values it had before the recall, switches to
+// the queued set in one go and fades back in. The queued set overrides the
+// live values until they have caught up.
+//
+// The slots are shared between the message thread and whichever thread the
+// host saves and restores state on, so they are guarded by a lock. Nothing on
+// the audio thread side allocates or locks.
+class ParameterSnapshots
+{
+public:
+    static constexpr int maxParameters = 32;
+    static constexpr int numSlots = 2; // A and B
+
+    // Plain (not normalised) values, in the order of the processor's parameters
+    using Values = std::array<float, maxParameters>;
+
+    explicit ParameterSnapshots(juce::AudioProcessorValueTreeState& state);
+
+    //==========================================================================
+    // Message thread, and the host's state calls
+
+    void store(int slot);
+    void recall(int slot);
+    bool hasSnapshot(int slot) const;
+
+    // The slot that was last stored or recalled, -1 if none
+    int getCurrentSlot() const;
+
+    int getNumParameters() const { return (int) parameters.size(); }
+    juce::String getParameterID(int index) const { return parameters[(size_t) index]->getParameterID(); }
+
+    // Saved alongside the APVTS state. Values are keyed by parameter ID so
+    // snapshots survive parameters being added or reordered.
+    juce::ValueTree toValueTree() const;
+    void fromValueTree(const juce::ValueTree& tree);
+
+    //==========================================================================
+    // Audio thread
+
+    void prepare(double sampleRate);
+
+    // Call at the start of every block; returns the values to process it with
+    const Values& beginBlock();
+
+    // True for the one block in which a recalled set took over. Smoothers
+    // should jump rather than glide, the output is silent at that point.
+    bool hasJumped() const { return jumped; }
+
+    // Call once the block has been processed; applies the dip
+    template <typename SampleType>
+    void applyFade(juce::AudioBuffer<SampleType>& buffer)
+    {
+        const int numSamples = buffer.getNumSamples();
+
+        if (overriding)
+            overrideSamplesLeft -= numSamples;
+
+        if (fade == Fade::none)
+            return;
+
+        const float startGain = gain;
+        gain = fade == Fade::out ? juce::jmax(0.0f, gain - gainStep * numSamples)
+                                 : juce::jmin(1.0f, gain + gainStep * numSamples);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            buffer.applyGainRamp(channel, 0, numSamples, static_cast<SampleType>(startGain), static_cast<SampleType>(gain));
+
+        if (fade == Fade::in && gain >= 1.0f)
+            fade = Fade::none;
+    }
+
+private:
+    Values readLive() const;
+
+    juce::AudioProcessorValueTreeState& apvts;
+    std::vector<juce::RangedAudioParameter*> parameters;
+    std::vector<std::atomic<float>*> liveValues;
+
+    struct Slot
+    {
+        Values values {};
+        bool stored = false;
+    };
+
+    // Guards slots and currentSlot; never taken on the audio thread
+    juce::CriticalSection slotLock;
+    std::array<Slot, numSlots> slots;
+    int currentSlot = -1;
+
+    // Recalled sets on their way to the audio thread
+    static constexpr int queueSize = 4;
+    juce::AbstractFifo queue { queueSize };
+    std::array<Values, queueSize> queuedValues {};
+
+    // Audio thread state
+    enum class Fade { none, out, in };
+    Fade fade = Fade::none;
+    float gain = 1.0f, gainStep = 1.0f;
+    Values blockValues {}, pendingValues {}, overrideValues {};
+    bool overriding = false, jumped = false, pending = false;
+    int overrideSamplesLeft = 0, overrideTimeout = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterSnapshots)
+};
@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    PerformanceMonitor.h
+    Created: 17 Oct 2026 12:57:19pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Lock-free record of what processBlock costs in a live session. Each block's
+// wall time is expressed as a fraction of its real-time budget
+// (numSamples / sampleRate) and binned; the audio thread is the only writer,
+// anyone can take a snapshot without locking.
+class PerformanceMonitor
+{
+public:
+    static constexpr int numLoadBins = 40;          // 5 % of the budget each, the last one is 195 % and up
+    static constexpr float loadBinWidth = 0.05f;
+
+    static constexpr int numBlockSizeBins = 11;     // <= 16, 32, 64 ... 8192, larger
+    static constexpr int numSampleRateBins = 7;     // 44.1, 48, 88.2, 96, 176.4, 192, other
+
+    // Times one processBlock call from construction to destruction
+    struct ScopedBlock
+    {
+        ScopedBlock(PerformanceMonitor& m, double sampleRate, int numSamples)
+            : monitor(m), rate(sampleRate), samples(numSamples), startTicks(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedBlock()
+        {
+            monitor.recordBlock(juce::Time::getHighResolutionTicks() - startTicks, rate, samples);
+        }
+
+        PerformanceMonitor& monitor;
+        double rate;
+        int samples;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+    struct Snapshot
+    {
+        juce::uint64 numBlocks = 0;
+        juce::uint64 numOverruns = 0;   // blocks that took longer than their budget
+        float meanLoad = 0.0f;          // fraction of the budget, 1.0 = 100 %
+        float maxLoad = 0.0f;
+
+        std::array<juce::uint32, numLoadBins> loadHistogram {};
+        std::array<juce::uint32, numBlockSizeBins> blockSizes {};
+        std::array<juce::uint32, numSampleRateBins> sampleRates {};
+    };
+
+    Snapshot getSnapshot() const
+    {
+        Snapshot s;
+        s.numBlocks = numBlocks.load(std::memory_order_relaxed);
+        s.numOverruns = numOverruns.load(std::memory_order_relaxed);
+        s.maxLoad = maxLoad.load(std::memory_order_relaxed);
+        s.meanLoad = s.numBlocks > 0 ? static_cast<float>(totalLoad.load(std::memory_order_relaxed) / static_cast<double>(s.numBlocks)) : 0.0f;
+
+        for (size_t i = 0; i < s.loadHistogram.size(); ++i)  s.loadHistogram[i] = loadHistogram[i].load(std::memory_order_relaxed);
+        for (size_t i = 0; i < s.blockSizes.size(); ++i)     s.blockSizes[i] = blockSizes[i].load(std::memory_order_relaxed);
+        for (size_t i = 0; i < s.sampleRates.size(); ++i)    s.sampleRates[i] = sampleRates[i].load(std::memory_order_relaxed);
+
+        return s;
+    }
+
+    // Asks the audio thread to start over at its next block
+    void reset() { resetRequested.store(true); }
+
+private:
+    void recordBlock(juce::int64 elapsedTicks, double sampleRate, int numSamples)
+    {
+        if (numSamples <= 0 || sampleRate <= 0.0)
+            return;
+
+        if (resetRequested.exchange(false))
+            clear();
+
+        double budgetSeconds = numSamples / sampleRate;
+        float load = static_cast<float>(juce::Time::highResolutionTicksToSeconds(elapsedTicks) / budgetSeconds);
+
+        increment(loadHistogram[(size_t) juce::jlimit(0, numLoadBins - 1, static_cast<int>(load / loadBinWidth))]);
+        increment(blockSizes[(size_t) getBlockSizeBin(numSamples)]);
+        increment(sampleRates[(size_t) getSampleRateBin(sampleRate)]);
+
+        if (load > 1.0f)
+            numOverruns.store(numOverruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        if (load > maxLoad.load(std::memory_order_relaxed))
+            maxLoad.store(load, std::memory_order_relaxed);
+
+        totalLoad.store(totalLoad.load(std::memory_order_relaxed) + load, std::memory_order_relaxed);
+        numBlocks.store(numBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void clear()
+    {
+        for (auto& bin : loadHistogram) bin.store(0, std::memory_order_relaxed);
+        for (auto& bin : blockSizes)    bin.store(0, std::memory_order_relaxed);
+        for (auto& bin : sampleRates)   bin.store(0, std::memory_order_relaxed);
+
+        numBlocks.store(0, std::memory_order_relaxed);
+        numOverruns.store(0, std::memory_order_relaxed);
+        maxLoad.store(0.0f, std::memory_order_relaxed);
+        totalLoad.store(0.0, std::memory_order_relaxed);
+    }
+
+    // Single writer, so a plain load/store pair is enough and avoids a locked instruction
+    static void increment(std::atomic<juce::uint32>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static int getBlockSizeBin(int numSamples)
+    {
+        int bin = 0;
+        for (int size = 16; size < numSamples && bin < numBlockSizeBins - 1; size *= 2)
+            ++bin;
+        return bin;
+    }
+
+    static int getSampleRateBin(double sampleRate)
+    {
+        constexpr double rates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+
+        for (int i = 0; i < numSampleRateBins - 1; ++i)
+            if (std::abs(sampleRate - rates[i]) < 1.0)
+                return i;
+
+        return numSampleRateBins - 1;
+    }
+
+    std::array<std::atomic<juce::uint32>, numLoadBins> loadHistogram {};
+    std::array<std::atomic<juce::uint32>, numBlockSizeBins> blockSizes {};
+    std::array<std::atomic<juce::uint32>, numSampleRateBins> sampleRates {};
+
+    std::atomic<juce::uint64> numBlocks { 0 }, numOverruns { 0 };
+    std::atomic<float> maxLoad { 0.0f };
+    std::atomic<double> totalLoad { 0.0 };
+    std::atomic<bool> resetRequested { false };
+};
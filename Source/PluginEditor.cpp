@@ -1,243 +1,564 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin editor.
-
-  ==============================================================================
-*/
-
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-
-//==============================================================================
-VectorScopeAudioProcessorEditor::VectorScopeAudioProcessorEditor (VectorScopeAudioProcessor& p, std::atomic<float>& correlationRef)
-: AudioProcessorEditor (&p), audioProcessor (p), correlationValue(correlationRef)
-{
-    addAndMakeVisible(vectorscope);
-    setSize (700, 395);
-    
-    background = juce::ImageCache::getFromMemory(BinaryData::FDImager8_png, BinaryData::FDImager8_pngSize);
-    
-    // Register this editor as a listener to the APVTS
-    audioProcessor.apvts.addParameterListener("soloLeft", this);
-    audioProcessor.apvts.addParameterListener("soloCenter", this);
-    audioProcessor.apvts.addParameterListener("soloRight", this);
-
-    // Ensure editor is repaintable when parameters change
-    setRepaintsOnMouseActivity(true);
-    
-    smoothedCorrelation.reset(60.0, 0.07);
-    smoothedCorrelation.setCurrentAndTargetValue(0.0f);
-    startTimer(30);
-}
-
-VectorScopeAudioProcessorEditor::~VectorScopeAudioProcessorEditor()
-{
-    // Remove listener on destruction
-    audioProcessor.apvts.removeParameterListener("soloLeft", this);
-    audioProcessor.apvts.removeParameterListener("soloCenter", this);
-    audioProcessor.apvts.removeParameterListener("soloRight", this);
-    
-    stopTimer();
-}
-
-//==============================================================================
-void VectorScopeAudioProcessorEditor::paint (juce::Graphics& g)
-{
-    auto font = juce::Typeface::createSystemTypefaceFor(BinaryData::JetBrainsMonoRegular_ttf, BinaryData::JetBrainsMonoRegular_ttfSize);
-    
-     
-    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-    
-    // Draws background image to screen
-    g.drawImageAt(background, 0, 0);
-    
-    // Draws LED lights to screen
-    g.setColour(audioProcessor.ledOnLParam-> load() > 0.5f ? juce::Colours::red : juce::Colours::darkred);
-    g.fillEllipse(ledBoundsL.toFloat());
-    
-    g.setColour(audioProcessor.ledOnCParam-> load() > 0.5f? juce::Colours::red : juce::Colours::darkred);
-    g.fillEllipse(ledBoundsC.toFloat());
-    
-    g.setColour(audioProcessor.ledOnRParam-> load() > 0.5f ? juce::Colours::red : juce::Colours::darkred);
-    g.fillEllipse(ledBoundsR.toFloat());
-    
-    
-    // Calculate number of LEDs to light
-    int numLit = juce::jlimit(0, 6, static_cast<int>(std::round(std::abs(displayVal) * 6.0f)));
-    
-    // Handle negative correlation
-    if (displayVal < 0.0f)
-    {
-        for (int i = 0; i < 6; ++i)
-        {
-            int ledIndex = 5 - i; // Reverse index: i=0 -> ledIndex=5, i=1 -> ledIndex=4, etc.
-            if (i < numLit)
-            {
-                if (ledIndex < 3)
-                {
-                    g.setColour(juce::Colours::red); // LEDs 0–2
-                }
-                else if (ledIndex < 5)
-                {
-                    g.setColour(juce::Colours::orange); // LEDs 3–4
-                }
-                else
-                {
-                    g.setColour(juce::Colours::yellow); // LEDs 5–6
-                }
-            }
-            else
-            {
-                g.setColour(juce::Colours::black.withAlpha(0.2f));
-            }
-            g.fillEllipse(ledsL[ledIndex].toFloat());
-            g.fillEllipse(ledsR[ledIndex].toFloat());
-        }
-
-        // Turn off positive side LEDs (6–11)
-        for (int i = 6; i < 12; ++i)
-        {
-            g.setColour(juce::Colours::black.withAlpha(0.2f));
-            g.fillEllipse(ledsL[i].toFloat());
-            g.fillEllipse(ledsR[i].toFloat());
-        }
-    }
-    // Handle positive correlation
-    else if (displayVal > 0.0f)
-    {
-        for (int i = 6; i < 12; ++i)
-        {
-            if (i - 6 < numLit)
-            {
-                g.setColour(juce::Colours::limegreen); // LEDs 6–11
-            }
-            else
-            {
-                g.setColour(juce::Colours::black.withAlpha(0.2f));
-            }
-            g.fillEllipse(ledsL[i].toFloat());
-            g.fillEllipse(ledsR[i].toFloat());
-        }
-
-        // Turn off negative side LEDs (0–5)
-        for (int i = 0; i < 6; ++i)
-        {
-            g.setColour(juce::Colours::black.withAlpha(0.2f));
-            g.fillEllipse(ledsL[i].toFloat());
-            g.fillEllipse(ledsR[i].toFloat());
-        }
-    }
-    // Handle zero correlation: turn off all LEDs
-    else
-    {
-        for (int i = 0; i < 12; ++i)
-        {
-            g.setColour(juce::Colours::black.withAlpha(0.2f));
-            g.fillEllipse(ledsL[i].toFloat());
-            g.fillEllipse(ledsR[i].toFloat());
-        }
-    }
-        
-    // Draws W/R values to screen
-    auto resultRotation = displayValues(width); // Width Value
-    g.setFont(juce::FontOptions(font).withHeight(20.0f));
-    g.setColour(juce::Colours::black);
-    g.drawText(resultRotation, 593, 172, 50, 26, juce::Justification::centred);
-    
-    auto resultWidth = displayValues(rotation); // Rotation Value
-    g.setFont(juce::FontOptions(font).withHeight(20.0f));
-    g.setColour(juce::Colours::black);
-    g.drawText(resultWidth, 493, 68, 50, 26, juce::Justification::centred);
-}
-
-void VectorScopeAudioProcessorEditor::resized()
-{
-    // Defines the area for the vectorscope (within the diamond)
-    int totalWidth = getWidth();
-    int totalHeight = getHeight();
-    
-    // Leave space for the right panel (1/4 width) and bottom buttons (1/10 height)
-    int scopeWidth = totalWidth * 0.35f;    // 35% of width
-    int scopeHeight = totalHeight * 0.7f;   // 70% of height
-    int xOffset = (totalWidth - scopeWidth) / 2 - 128;  // Center horizontally
-    int yOffset = (totalHeight - scopeHeight) / 10 + 4; // Leave space at bottom
-
-    // Sets the vectorscope bounds
-    vectorscope.setBounds(xOffset, yOffset, scopeWidth, scopeHeight);
-}
-
-void VectorScopeAudioProcessorEditor::pushSamples(const float* leftSamples, const float* rightSamples, int numSamples)
-{
-    vectorscope.pushSamples(leftSamples, rightSamples, numSamples);
-}
-
-juce::String VectorScopeAudioProcessorEditor::displayValues(int val)
-{
-    juce::String modifiedR = juce::String(val).paddedLeft('0', 3); // Prepends zeros to String.
-    juce::String spacedString;
-    
-    for (int i = 0; i < modifiedR.length(); ++i)
-    {
-        spacedString += modifiedR[i];
-        if (i < modifiedR.length() - 1)
-            spacedString += " "; // Append space between numbers
-    }
-    return spacedString;
-}
-
-void VectorScopeAudioProcessorEditor::mouseDown(const juce::MouseEvent& event)
-{
-    // Get click position
-    juce::Point<int> clickPos = event.getPosition();
-
-    // Check if the click is inside one of the defined areas
-    if (area1.contains(clickPos))
-    {
-        bool currentState = audioProcessor.ledOnLParam->load() > 0.5f;
-        audioProcessor.apvts.getParameter("soloLeft")->setValueNotifyingHost(currentState ? 0.0f : 1.0f);
-    }
-    else if (area2.contains(clickPos))
-    {
-        bool currentState = audioProcessor.ledOnCParam->load() > 0.5f;
-        audioProcessor.apvts.getParameter("soloCenter")->setValueNotifyingHost(currentState ? 0.0f : 1.0f);
-    }
-    else if (area3.contains(clickPos))
-    {
-        bool currentState = audioProcessor.ledOnRParam->load() > 0.5f;
-        audioProcessor.apvts.getParameter("soloRight")->setValueNotifyingHost(currentState ? 0.0f : 1.0f);
-    }
-    else if (rotationUp.contains(clickPos) && (rotation < 100))
-    {
-        rotation += 1;
-        repaint();
-    }
-    else if (rotationDown.contains(clickPos) && (rotation > 0))
-    {
-        rotation -= 1;
-        repaint();
-    }
-    else if (widthUp.contains(clickPos) && (width < 200))
-    {
-        width += 1;
-        repaint();
-    }
-    else if (widthDown.contains(clickPos) && (width > 0))
-    {
-        width -= 1;
-        repaint();
-    }
-}
-
-void VectorScopeAudioProcessorEditor::timerCallback()
-{
-    float rawCorrelation = audioProcessor.correlationValue.load();
-    smoothedCorrelation.setTargetValue(rawCorrelation);
-    displayVal = smoothedCorrelation.getNextValue();
-    repaint();
-}
-
-void VectorScopeAudioProcessorEditor::parameterChanged(const juce::String &parameterID, float newValue)
-{
-    repaint();
-}
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+//==============================================================================
+VectorScopeAudioProcessorEditor::VectorScopeAudioProcessorEditor (VectorScopeAudioProcessor& p, std::atomic<float>& correlationRef)
+: AudioProcessorEditor (&p), audioProcessor (p), vectorscope (p.scopeFifo), correlationValue(correlationRef)
+{
+    addAndMakeVisible(vectorscope);
+    vectorscope.setInterceptsMouseClicks(false, false); // Clicks over the scope come to mouseDown
+    setSize (700, 395);
+    
+    background = juce::ImageCache::getFromMemory(BinaryData::FDImager8_png, BinaryData::FDImager8_pngSize);
+    
+    typeface = juce::Typeface::createSystemTypefaceFor(BinaryData::JetBrainsMonoRegular_ttf, BinaryData::JetBrainsMonoRegular_ttfSize);
+    readoutFont = juce::Font(juce::FontOptions(typeface).withHeight(20.0f));
+    createLedSprites();
+    
+    // Stepped in milliseconds, so the glide takes as long at any display rate
+    smoothedCorrelation.reset(1000.0, 0.07);
+    smoothedCorrelation.setCurrentAndTargetValue(0.0f);
+    
+    // Parameters (including host automation) are picked up by refresh()
+    shown = readDisplayState();
+}
+
+VectorScopeAudioProcessorEditor::~VectorScopeAudioProcessorEditor()
+{
+    // Nothing else reads the matrix
+    audioProcessor.correlationMatrix.setEnabled(false);
+}
+
+//==============================================================================
+void VectorScopeAudioProcessorEditor::paint (juce::Graphics& g)
+{
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+    
+    // Draws background image to screen (only the invalidated part is actually blitted)
+    g.drawImageAt(background, 0, 0);
+    
+    // Draws LED lights to screen
+    drawLed(g, ledBoundsL, shown.soloLeft ? soloOn : soloOff);
+    drawLed(g, ledBoundsC, shown.soloCenter ? soloOn : soloOff);
+    drawLed(g, ledBoundsR, shown.soloRight ? soloOn : soloOff);
+    
+    // Correlation meter
+    if (g.clipRegionIntersects(correlationLedArea))
+    {
+        for (int i = 0; i < 12; ++i)
+        {
+            auto sprite = getCorrelationLedSprite(i, shown.correlationLeds);
+            drawLed(g, ledsL[(size_t) i], sprite);
+            drawLed(g, ledsR[(size_t) i], sprite);
+        }
+    }
+        
+    // Draws W/R values to screen
+    g.setFont(readoutFont);
+    g.setColour(juce::Colours::black);
+    
+    if (g.clipRegionIntersects(widthReadout))
+        g.drawText(displayValues(shown.width), widthReadout, juce::Justification::centred);
+    
+    if (g.clipRegionIntersects(rotationReadout))
+        g.drawText(displayValues(shown.rotation), rotationReadout, juce::Justification::centred);
+}
+
+void VectorScopeAudioProcessorEditor::paintOverChildren (juce::Graphics& g)
+{
+    if (audioProcessor.spectralCorrelation.isEnabled() && g.clipRegionIntersects(vectorscope.getBounds()))
+        drawSpectralCorrelation(g, vectorscope.getBounds().toFloat());
+    
+    if (showCorrelationMatrix && g.clipRegionIntersects(vectorscope.getBounds()))
+        drawCorrelationMatrix(g, vectorscope.getBounds().toFloat());
+    
+    if (showLoudness && g.clipRegionIntersects(loudnessArea))
+        drawLoudness(g);
+    
+    if (showBandCorrelation && g.clipRegionIntersects(bandCorrelationArea))
+        drawBandCorrelation(g);
+    
+    if (! showPerformanceOverlay || ! g.clipRegionIntersects(performanceOverlayArea))
+        return;
+    
+    auto stats = audioProcessor.performanceMonitor.getSnapshot();
+    
+    // Most common block size, as the host is actually calling us
+    auto commonBin = std::distance(stats.blockSizes.begin(), std::max_element(stats.blockSizes.begin(), stats.blockSizes.end()));
+    auto blockSizeText = commonBin == 0 ? juce::String("<= 16")
+                       : commonBin == PerformanceMonitor::numBlockSizeBins - 1 ? juce::String("> 8192")
+                       : juce::String(16 << commonBin);
+    
+    juce::String text;
+    text << "load  avg " << juce::String(stats.meanLoad * 100.0f, 2) << " %   max " << juce::String(stats.maxLoad * 100.0f, 1) << " %\n"
+         << "blocks " << juce::String((juce::int64) stats.numBlocks) << "   overruns " << juce::String((juce::int64) stats.numOverruns) << "\n"
+         << "block size " << blockSizeText << " @ " << juce::String(audioProcessor.getSampleRate() / 1000.0, 1) << " kHz\n"
+         << "guard  muted " << juce::String(audioProcessor.earProtection.nonFiniteEvents.load())
+         << "   > +6 dB " << juce::String(audioProcessor.earProtection.overloadEvents.load());
+    
+    g.setColour(juce::Colours::black.withAlpha(0.75f));
+    g.fillRect(performanceOverlayArea);
+    g.setColour(juce::Colours::white);
+    g.setFont(readoutFont.withHeight(12.0f));
+    g.drawMultiLineText(text, performanceOverlayArea.getX() + 6, performanceOverlayArea.getY() + 16, performanceOverlayArea.getWidth() - 12);
+}
+
+void VectorScopeAudioProcessorEditor::drawSpectralCorrelation(juce::Graphics& g, juce::Rectangle<float> area) const
+{
+    const auto& spectrum = audioProcessor.spectralCorrelation;
+    constexpr int numBands = SpectralCorrelation::numBands;
+    
+    g.setColour(juce::Colours::black.withAlpha(0.6f));
+    g.fillRect(area);
+    
+    auto plot = area.reduced(8.0f);
+    auto bandX = [&](int band) { return plot.getX() + plot.getWidth() * band / (numBands - 1.0f); };
+    
+    // +1 at the top, -1 at the bottom
+    g.setColour(juce::Colours::white.withAlpha(0.3f));
+    g.drawHorizontalLine(juce::roundToInt(plot.getCentreY()), plot.getX(), plot.getRight());
+    
+    juce::Path correlation, phase;
+    
+    for (int band = 0; band < numBands; ++band)
+    {
+        juce::Point<float> c { bandX(band), plot.getCentreY() - spectrum.getCorrelation(band) * plot.getHeight() * 0.5f };
+        juce::Point<float> p { bandX(band), plot.getCentreY() - spectrum.getPhase(band) / juce::MathConstants<float>::pi * plot.getHeight() * 0.5f };
+        
+        if (band == 0)
+        {
+            correlation.startNewSubPath(c);
+            phase.startNewSubPath(p);
+        }
+        else
+        {
+            correlation.lineTo(c);
+            phase.lineTo(p);
+        }
+    }
+    
+    g.setColour(juce::Colours::orange.withAlpha(0.6f));
+    g.strokePath(phase, juce::PathStrokeType(1.0f));
+    g.setColour(juce::Colours::limegreen);
+    g.strokePath(correlation, juce::PathStrokeType(2.0f));
+    
+    // Decade markers
+    g.setFont(readoutFont.withHeight(10.0f));
+    g.setColour(juce::Colours::white.withAlpha(0.6f));
+    
+    for (auto [band, label] : { std::pair<int, const char*> { 0, "20" }, { 10, "200" }, { 20, "2k" }, { 30, "20k" } })
+        g.drawText(label, juce::Rectangle<float>(bandX(band) - 15.0f, plot.getBottom() - 12.0f, 30.0f, 12.0f), juce::Justification::centred);
+}
+
+void VectorScopeAudioProcessorEditor::drawCorrelationMatrix(juce::Graphics& g, juce::Rectangle<float> area) const
+{
+    auto layout = audioProcessor.getChannelLayoutOfBus(true, 0);
+    const int numChannels = juce::jmin(layout.size(), CorrelationMatrix::maxChannels);
+    
+    if (numChannels <= 2)
+        return;
+    
+    g.setColour(juce::Colours::black.withAlpha(0.6f));
+    g.fillRect(area);
+    
+    // Square cells, names on the diagonal; green towards +1, red towards -1
+    const float cellSize = juce::jmin(area.getWidth(), area.getHeight()) / static_cast<float>(numChannels);
+    auto grid = area.withSizeKeepingCentre(cellSize * numChannels, cellSize * numChannels);
+    const auto& matrix = audioProcessor.correlationMatrix;
+    
+    g.setFont(readoutFont.withHeight(juce::jmin(10.0f, cellSize * 0.6f)));
+    
+    for (int a = 0; a < numChannels; ++a)
+    {
+        for (int b = 0; b < numChannels; ++b)
+        {
+            juce::Rectangle<float> cell { grid.getX() + b * cellSize, grid.getY() + a * cellSize, cellSize, cellSize };
+            
+            if (a == b)
+            {
+                g.setColour(juce::Colours::white.withAlpha(0.8f));
+                g.drawText(juce::AudioChannelSet::getAbbreviatedChannelTypeName(layout.getTypeOfChannel(a)),
+                           cell, juce::Justification::centred, false);
+                continue;
+            }
+            
+            float correlation = matrix.getCorrelation(a, b);
+            auto colour = correlation < 0.0f ? juce::Colours::red : juce::Colours::limegreen;
+            
+            g.setColour(colour.withAlpha(std::abs(correlation)));
+            g.fillRect(cell.reduced(1.0f));
+        }
+    }
+}
+
+void VectorScopeAudioProcessorEditor::drawLoudness(juce::Graphics& g) const
+{
+    auto level = [](float value)
+    {
+        return value <= CorrelationMeter::minimumLevel ? juce::String("-inf") : juce::String(value, 1);
+    };
+    
+    juce::String text;
+    text << "M  " << level(audioProcessor.momentaryLoudness.load()) << " LUFS"
+         << "   S  " << level(audioProcessor.shortTermLoudness.load()) << " LUFS\n"
+         << "I  " << level(audioProcessor.integratedLoudness.load()) << " LUFS\n"
+         << "TP  " << level(audioProcessor.truePeakLeft.load()) << " / " << level(audioProcessor.truePeakRight.load()) << " dBTP\n"
+         << "M/S  " << juce::String(audioProcessor.midSideRatio.load(), 1) << " dB";
+    
+    g.setColour(juce::Colours::black.withAlpha(0.75f));
+    g.fillRect(loudnessArea);
+    g.setColour(juce::Colours::white);
+    g.setFont(readoutFont.withHeight(12.0f));
+    g.drawMultiLineText(text, loudnessArea.getX() + 6, loudnessArea.getY() + 16, loudnessArea.getWidth() - 12);
+}
+
+void VectorScopeAudioProcessorEditor::drawBandCorrelation(juce::Graphics& g) const
+{
+    g.setColour(juce::Colours::black.withAlpha(0.75f));
+    g.fillRect(bandCorrelationArea);
+    g.setFont(readoutFont.withHeight(12.0f));
+    
+    // One row per band, lowest first: value, then a bar growing from the centre
+    const int numBands = juce::jlimit(1, MultibandWidth::maxBands, juce::roundToInt(audioProcessor.bandsParam->load()));
+    auto rows = bandCorrelationArea.reduced(6, 5);
+    const int rowHeight = rows.getHeight() / MultibandWidth::maxBands;
+    
+    for (int band = 0; band < numBands; ++band)
+    {
+        // A single band is the broadband signal, which the main meter already shows
+        const float correlation = numBands > 1 ? audioProcessor.multibandWidth.getBandCorrelation(band)
+                                               : audioProcessor.correlationValue.load();
+        
+        auto row = rows.removeFromTop(rowHeight);
+        g.setColour(juce::Colours::white);
+        g.drawText("B" + juce::String(band + 1) + juce::String(correlation, 2).paddedLeft(' ', 6),
+                   row.removeFromLeft(80), juce::Justification::centredLeft, false);
+        
+        auto bar = row.reduced(0, 3).toFloat();
+        g.setColour(juce::Colours::white.withAlpha(0.3f));
+        g.drawVerticalLine(juce::roundToInt(bar.getCentreX()), bar.getY(), bar.getBottom());
+        
+        const float length = bar.getWidth() * 0.5f * correlation;
+        g.setColour(correlation < 0.0f ? juce::Colours::red : juce::Colours::limegreen);
+        g.fillRect(juce::Rectangle<float>(bar.getCentreX() + juce::jmin(0.0f, length), bar.getY(), std::abs(length), bar.getHeight()));
+    }
+}
+
+void VectorScopeAudioProcessorEditor::createLedSprites()
+{
+    // Rendered at 2x so they stay sharp on high-DPI displays
+    constexpr int spriteScale = 2;
+    
+    auto makeSprite = [](juce::Colour colour)
+    {
+        juce::Image sprite(juce::Image::ARGB, 8 * spriteScale, 8 * spriteScale, true);
+        juce::Graphics g(sprite);
+        g.setColour(colour);
+        g.fillEllipse(sprite.getBounds().toFloat());
+        return sprite;
+    };
+    
+    ledSprites[ledOff]    = makeSprite(juce::Colours::black.withAlpha(0.2f));
+    ledSprites[ledRed]    = makeSprite(juce::Colours::red);
+    ledSprites[ledOrange] = makeSprite(juce::Colours::orange);
+    ledSprites[ledYellow] = makeSprite(juce::Colours::yellow);
+    ledSprites[ledGreen]  = makeSprite(juce::Colours::limegreen);
+    ledSprites[soloOn]    = makeSprite(juce::Colours::red);
+    ledSprites[soloOff]   = makeSprite(juce::Colours::darkred);
+}
+
+void VectorScopeAudioProcessorEditor::drawLed(juce::Graphics& g, juce::Rectangle<int> bounds, LedSprite sprite) const
+{
+    if (g.clipRegionIntersects(bounds))
+        g.drawImage(ledSprites[(size_t) sprite], bounds.toFloat());
+}
+
+VectorScopeAudioProcessorEditor::LedSprite VectorScopeAudioProcessorEditor::getCorrelationLedSprite(int ledIndex, int litLeds) const
+{
+    // Negative correlation lights LEDs 5, 4, 3... outwards from the centre
+    if (litLeds < 0 && ledIndex < 6 && ledIndex >= 6 + litLeds)
+    {
+        if (ledIndex < 3) return ledRed;    // LEDs 0–2
+        if (ledIndex < 5) return ledOrange; // LEDs 3–4
+        return ledYellow;                   // LED 5
+    }
+    
+    // Positive correlation lights LEDs 6, 7, 8... outwards from the centre
+    if (litLeds > 0 && ledIndex >= 6 && ledIndex - 6 < litLeds)
+        return ledGreen;
+    
+    return ledOff;
+}
+
+void VectorScopeAudioProcessorEditor::resized()
+{
+    // Defines the area for the vectorscope (within the diamond)
+    int totalWidth = getWidth();
+    int totalHeight = getHeight();
+    
+    // Leave space for the right panel (1/4 width) and bottom buttons (1/10 height)
+    int scopeWidth = totalWidth * 0.35f;    // 35% of width
+    int scopeHeight = totalHeight * 0.7f;   // 70% of height
+    int xOffset = (totalWidth - scopeWidth) / 2 - 128;  // Center horizontally
+    int yOffset = (totalHeight - scopeHeight) / 10 + 4; // Leave space at bottom
+
+    // Sets the vectorscope bounds
+    vectorscope.setBounds(xOffset, yOffset, scopeWidth, scopeHeight);
+}
+
+juce::String VectorScopeAudioProcessorEditor::displayValues(int val)
+{
+    juce::String modifiedR = juce::String(val).paddedLeft('0', 3); // Prepends zeros to String.
+    juce::String spacedString;
+    
+    for (int i = 0; i < modifiedR.length(); ++i)
+    {
+        spacedString += modifiedR[i];
+        if (i < modifiedR.length() - 1)
+            spacedString += " "; // Append space between numbers
+    }
+    return spacedString;
+}
+
+void VectorScopeAudioProcessorEditor::mouseDown(const juce::MouseEvent& event)
+{
+    // Get click position
+    juce::Point<int> clickPos = event.getPosition();
+
+    // Check if the click is inside one of the defined areas
+    if (event.mods.isAltDown())
+    {
+        showPerformanceOverlay = ! showPerformanceOverlay;
+        repaint(performanceOverlayArea);
+    }
+    else if (event.mods.isPopupMenu() && vectorscope.getBounds().contains(clickPos))
+    {
+        showScopeMenu();
+    }
+    else if (event.mods.isPopupMenu())
+    {
+        showSnapshotMenu();
+    }
+    else if (area1.contains(clickPos))
+    {
+        bool currentState = audioProcessor.ledOnLParam->load() > 0.5f;
+        audioProcessor.apvts.getParameter("soloLeft")->setValueNotifyingHost(currentState ? 0.0f : 1.0f);
+    }
+    else if (area2.contains(clickPos))
+    {
+        bool currentState = audioProcessor.ledOnCParam->load() > 0.5f;
+        audioProcessor.apvts.getParameter("soloCenter")->setValueNotifyingHost(currentState ? 0.0f : 1.0f);
+    }
+    else if (area3.contains(clickPos))
+    {
+        bool currentState = audioProcessor.ledOnRParam->load() > 0.5f;
+        audioProcessor.apvts.getParameter("soloRight")->setValueNotifyingHost(currentState ? 0.0f : 1.0f);
+    }
+    else if (rotationUp.contains(clickPos))
+    {
+        nudgeParameter("rotation", 1);
+    }
+    else if (rotationDown.contains(clickPos))
+    {
+        nudgeParameter("rotation", -1);
+    }
+    else if (widthUp.contains(clickPos))
+    {
+        nudgeParameter("width", 1);
+    }
+    else if (widthDown.contains(clickPos))
+    {
+        nudgeParameter("width", -1);
+    }
+}
+
+void VectorScopeAudioProcessorEditor::nudgeParameter(const juce::String& parameterID, int delta)
+{
+    if (auto* param = audioProcessor.apvts.getParameter(parameterID))
+    {
+        const auto& range = param->getNormalisableRange();
+        float newValue = range.snapToLegalValue(param->convertFrom0to1(param->getValue()) + static_cast<float>(delta));
+        
+        param->beginChangeGesture();
+        param->setValueNotifyingHost(param->convertTo0to1(newValue));
+        param->endChangeGesture();
+    }
+}
+
+void VectorScopeAudioProcessorEditor::showScopeMenu()
+{
+    juce::PopupMenu menu;
+    menu.addItem("Persistence", true, vectorscope.isPersistenceEnabled(), [this]
+    {
+        vectorscope.setPersistenceEnabled(! vectorscope.isPersistenceEnabled());
+    });
+    
+    menu.addItem("Spectral Correlation", true, audioProcessor.spectralCorrelation.isEnabled(), [this]
+    {
+        audioProcessor.spectralCorrelation.setEnabled(! audioProcessor.spectralCorrelation.isEnabled());
+        repaint(vectorscope.getBounds());
+    });
+    
+    menu.addItem("Loudness", true, showLoudness, [this]
+    {
+        showLoudness = ! showLoudness;
+        repaint(loudnessArea);
+    });
+    
+    menu.addItem("Reset Loudness", [this] { audioProcessor.resetLoudness(); });
+    
+    menu.addItem("Band Correlation", true, showBandCorrelation, [this]
+    {
+        showBandCorrelation = ! showBandCorrelation;
+        repaint(bandCorrelationArea);
+    });
+    
+    menu.addItem("Shared Memory Export", true, audioProcessor.sharedMemoryExport.isEnabled(), [this]
+    {
+        auto& sharedExport = audioProcessor.sharedMemoryExport;
+        sharedExport.setEnabled(! sharedExport.isEnabled());
+    });
+    
+    juce::PopupMenu modeMenu;
+    for (int index = 0; index < numScopeModes; ++index)
+    {
+        auto mode = static_cast<ScopeMode>(index);
+        modeMenu.addItem(getScopeModeName(mode), true, vectorscope.getDisplayMode() == mode,
+                         [this, mode] { vectorscope.setDisplayMode(mode); });
+    }
+    
+    juce::PopupMenu windowMenu;
+    for (float ms : { 10.0f, 23.0f, 50.0f, 100.0f, 200.0f })
+        windowMenu.addItem(juce::String(ms, 0) + " ms", true, audioProcessor.getScopeWindow() == ms,
+                           [this, ms] { audioProcessor.setScopeWindow(ms); });
+    
+    juce::PopupMenu pointsMenu;
+    for (int points : { 512, 1024, 2048, 4096 })
+        pointsMenu.addItem(juce::String(points), true, audioProcessor.getScopePointBudget() == points,
+                           [this, points] { audioProcessor.setScopePointBudget(points); });
+    
+    // Any two channels of a surround bus can be put on the scope and the meter
+    auto layout = audioProcessor.getChannelLayoutOfBus(true, 0);
+    juce::PopupMenu pairMenu;
+    
+    if (layout.size() > 2)
+    {
+        auto current = audioProcessor.getAnalysisPair();
+        
+        for (int a = 0; a < layout.size(); ++a)
+        {
+            for (int b = a + 1; b < layout.size(); ++b)
+            {
+                auto name = juce::AudioChannelSet::getAbbreviatedChannelTypeName(layout.getTypeOfChannel(a)) + " / "
+                          + juce::AudioChannelSet::getAbbreviatedChannelTypeName(layout.getTypeOfChannel(b));
+                
+                pairMenu.addItem(name, true, current == std::make_pair(a, b), [this, a, b] { audioProcessor.setAnalysisPair(a, b); });
+            }
+        }
+    }
+    
+    menu.addSeparator();
+    
+    if (pairMenu.getNumItems() > 0)
+    {
+        menu.addSubMenu("Channel Pair", pairMenu);
+        menu.addItem("Correlation Matrix", true, showCorrelationMatrix, [this]
+        {
+            showCorrelationMatrix = ! showCorrelationMatrix;
+            audioProcessor.correlationMatrix.setEnabled(showCorrelationMatrix);
+            repaint(vectorscope.getBounds());
+        });
+    }
+    
+    menu.addSubMenu("Display", modeMenu);
+    menu.addSubMenu("Time Window", windowMenu);
+    menu.addSubMenu("Points per Frame", pointsMenu);
+    
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&vectorscope));
+}
+
+void VectorScopeAudioProcessorEditor::showSnapshotMenu()
+{
+    auto& snapshots = audioProcessor.parameterSnapshots;
+    juce::PopupMenu menu;
+    
+    for (int slot = 0; slot < ParameterSnapshots::numSlots; ++slot)
+    {
+        auto name = juce::String::charToString(static_cast<juce::juce_wchar>('A' + slot));
+        menu.addItem("Recall " + name, snapshots.hasSnapshot(slot), snapshots.getCurrentSlot() == slot,
+                     [&snapshots, slot] { snapshots.recall(slot); });
+    }
+    
+    menu.addSeparator();
+    
+    for (int slot = 0; slot < ParameterSnapshots::numSlots; ++slot)
+    {
+        auto name = juce::String::charToString(static_cast<juce::juce_wchar>('A' + slot));
+        menu.addItem("Store as " + name, [&snapshots, slot] { snapshots.store(slot); });
+    }
+    
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this).withMousePosition());
+}
+
+VectorScopeAudioProcessorEditor::DisplayState VectorScopeAudioProcessorEditor::readDisplayState() const
+{
+    DisplayState state;
+    state.soloLeft = audioProcessor.ledOnLParam->load() > 0.5f;
+    state.soloCenter = audioProcessor.ledOnCParam->load() > 0.5f;
+    state.soloRight = audioProcessor.ledOnRParam->load() > 0.5f;
+    state.rotation = juce::roundToInt(audioProcessor.rotationParam->load());
+    state.width = juce::roundToInt(audioProcessor.widthParam->load());
+    
+    // Calculate number of LEDs to light
+    int numLit = juce::jlimit(0, 6, static_cast<int>(std::round(std::abs(displayVal) * 6.0f)));
+    state.correlationLeds = displayVal < 0.0f ? -numLit : numLit;
+    
+    return state;
+}
+
+void VectorScopeAudioProcessorEditor::refresh(double timestampSeconds)
+{
+    double elapsed = juce::jlimit(0.0, 0.1, timestampSeconds - lastRefreshTime);
+    lastRefreshTime = timestampSeconds;
+    
+    // Minimised, or hidden by the host
+    if (! isShowing())
+        return;
+    
+    if (vectorscope.refresh())
+        lastActivityTime = timestampSeconds;
+    
+    bool audioActive = timestampSeconds - lastActivityTime < settleSeconds;
+    
+    float rawCorrelation = audioProcessor.correlationValue.load();
+    smoothedCorrelation.setTargetValue(rawCorrelation);
+    displayVal = smoothedCorrelation.skip(juce::roundToInt(elapsed * 1000.0));
+    
+    auto next = readDisplayState();
+    
+    if (next.soloLeft != shown.soloLeft)                 repaint(ledBoundsL);
+    if (next.soloCenter != shown.soloCenter)             repaint(ledBoundsC);
+    if (next.soloRight != shown.soloRight)               repaint(ledBoundsR);
+    if (next.correlationLeds != shown.correlationLeds)   repaint(correlationLedArea);
+    if (next.rotation != shown.rotation)                 repaint(rotationReadout);
+    if (next.width != shown.width)                       repaint(widthReadout);
+    if (showPerformanceOverlay)                          repaint(performanceOverlayArea);
+    
+    if (audioActive)
+    {
+        if (showLoudness)                                 repaint(loudnessArea);
+        if (showBandCorrelation)                          repaint(bandCorrelationArea);
+        if (audioProcessor.spectralCorrelation.isEnabled()) repaint(vectorscope.getBounds());
+        if (showCorrelationMatrix)                        repaint(vectorscope.getBounds());
+    }
+    
+    shown = next;
+}
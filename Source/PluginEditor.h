@@ -1,120 +1,182 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin editor.
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include "PluginProcessor.h"
-#include "VectorscopeComponent.h"
-
-//==============================================================================
-/**
-*/
-class VectorScopeAudioProcessorEditor  : public juce::AudioProcessorEditor, public juce::AudioProcessorValueTreeState::Listener, private juce::Timer
-{
-public:
-    VectorScopeAudioProcessorEditor (VectorScopeAudioProcessor&, std::atomic<float>&);
-    ~VectorScopeAudioProcessorEditor() override;
-
-    //==============================================================================
-    void paint (juce::Graphics&) override;
-    void resized() override;
-    
-    void pushSamples(const float* leftSamples, const float* rightSamples, int numSamples);
-    juce::String displayValues (int val);
-    
-    void mouseDown(const juce::MouseEvent& event) override;
-private:
-    VectorScopeAudioProcessor& audioProcessor;
-    VectorscopeComponent vectorscope;
-    
-    void timerCallback() override;
-    
-    int rotation = 0;
-    int width = 100;
-    
-    juce::Image background;
-    
-    // Define clickable areas
-    juce::Rectangle<int> area1 {93, 330, 31, 31};  // L
-    juce::Rectangle<int> area2 {206, 330, 31, 31}; // C
-    juce::Rectangle<int> area3 {319, 330, 31, 31}; // R
-    
-    // Define LED lights
-    juce::Rectangle<int> ledBoundsL {105, 341, 8, 8}; // L
-    juce::Rectangle<int> ledBoundsC {218, 341, 8, 8}; // C
-    juce::Rectangle<int> ledBoundsR {331, 341, 8, 8}; // R
-    
-    // Define the clickable areas for W/R
-    juce::Rectangle<int> rotationUp {510, 38, 17, 17}; // Rotation Up
-    juce::Rectangle<int> rotationDown {510, 106, 17, 17}; // Rotation Down
-    juce::Rectangle<int> widthUp {609, 143, 17, 17}; // Width Up
-    juce::Rectangle<int> widthDown {609, 211, 17, 17}; // Width Down
-    
-    //==========================================================================
-    // STEREO CORRLEATION METER LEDS
-    
-    juce::Rectangle<int> led1L {478, 255, 8, 8};
-    juce::Rectangle<int> led1R {478, 268, 8, 8};
-    
-    juce::Rectangle<int> led2L {493, 255, 8, 8};
-    juce::Rectangle<int> led2R {493, 268, 8, 8};
-    
-    juce::Rectangle<int> led3L {508, 255, 8, 8};
-    juce::Rectangle<int> led3R {508, 268, 8, 8};
-    
-    juce::Rectangle<int> led4L {523, 255, 8, 8};
-    juce::Rectangle<int> led4R {523, 268, 8, 8};
-    
-    juce::Rectangle<int> led5L {538, 255, 8, 8};
-    juce::Rectangle<int> led5R {538, 268, 8, 8};
-    
-    juce::Rectangle<int> led6L {553, 255, 8, 8};
-    juce::Rectangle<int> led6R {553, 268, 8, 8};
-    
-    juce::Rectangle<int> led7L {576, 255, 8, 8};
-    juce::Rectangle<int> led7R {576, 268, 8, 8};
-    
-    juce::Rectangle<int> led8L {591, 255, 8, 8};
-    juce::Rectangle<int> led8R {591, 268, 8, 8};
-    
-    juce::Rectangle<int> led9L {606, 255, 8, 8};
-    juce::Rectangle<int> led9R {606, 268, 8, 8};
-    
-    juce::Rectangle<int> led10L {621, 255, 8, 8};
-    juce::Rectangle<int> led10R {621, 268, 8, 8};
-    
-    juce::Rectangle<int> led11L {636, 255, 8, 8};
-    juce::Rectangle<int> led11R {636, 268, 8, 8};
-    
-    juce::Rectangle<int> led12L {651, 255, 8, 8};
-    juce::Rectangle<int> led12R {651, 268, 8, 8};
-    
-    std::vector<juce::Rectangle<int>> ledsL =
-    {
-        led1L, led2L, led3L, led4L, led5L, led6L,
-        led7L, led8L, led9L, led10L, led11L, led12L
-    };
-    
-    std::vector<juce::Rectangle<int>> ledsR =
-    {
-        led1R, led2R, led3R, led4R, led5R, led6R,
-        led7R, led8R, led9R, led10R, led11R, led12R
-    };
-    
-    std::atomic<float>& correlationValue;
-    juce::SmoothedValue<float> smoothedCorrelation { 0.0f };
-    float displayVal = 0.0f;
-    
-    
-    //==========================================================================
-    // Listener callback
-    void parameterChanged(const juce::String& parameterID, float newValue) override;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VectorScopeAudioProcessorEditor)
-};
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "VectorscopeComponent.h"
+
+//==============================================================================
+/**
+*/
+class VectorScopeAudioProcessorEditor  : public juce::AudioProcessorEditor
+{
+public:
+    VectorScopeAudioProcessorEditor (VectorScopeAudioProcessor&, std::atomic<float>&);
+    ~VectorScopeAudioProcessorEditor() override;
+
+    //==============================================================================
+    void paint (juce::Graphics&) override;
+    void paintOverChildren (juce::Graphics&) override;
+    void resized() override;
+    
+    juce::String displayValues (int val);
+    
+    void mouseDown(const juce::MouseEvent& event) override;
+private:
+    VectorScopeAudioProcessor& audioProcessor;
+    VectorscopeComponent vectorscope;
+    
+    // Once per display frame. Does nothing while the editor isn't showing;
+    // the audio-driven overlays stop once the audio has gone quiet and the
+    // slowest meter has settled.
+    void refresh(double timestampSeconds);
+    
+    static constexpr double settleSeconds = 3.0; // short-term loudness window
+    double lastRefreshTime = 0.0, lastActivityTime = -settleSeconds;
+    
+    // Steps an integer parameter by one, clamped to its range
+    void nudgeParameter(const juce::String& parameterID, int delta);
+    
+    // Right-click menu over the scope for its display options
+    void showScopeMenu();
+    
+    // Right-click anywhere else: store and recall the A/B snapshots
+    void showSnapshotMenu();
+    
+    // Per-band correlation (and phase) of the analysis pair, drawn over the scope
+    void drawSpectralCorrelation(juce::Graphics& g, juce::Rectangle<float> area) const;
+    
+    // Correlation of every channel pair of a surround bus, as a grid over the
+    // scope. The processor only computes the matrix while this is shown.
+    bool showCorrelationMatrix = false;
+    void drawCorrelationMatrix(juce::Graphics& g, juce::Rectangle<float> area) const;
+    
+    juce::Image background;
+    
+    // Loaded once; creating the typeface from BinaryData is far too slow for paint()
+    juce::Typeface::Ptr typeface;
+    juce::Font readoutFont { juce::FontOptions() };
+    
+    // Pre-rendered LEDs so paint() only blits
+    enum LedSprite { ledOff, ledRed, ledOrange, ledYellow, ledGreen, soloOn, soloOff, numLedSprites };
+    std::array<juce::Image, numLedSprites> ledSprites;
+    void createLedSprites();
+    void drawLed(juce::Graphics& g, juce::Rectangle<int> bounds, LedSprite sprite) const;
+    LedSprite getCorrelationLedSprite(int ledIndex, int litLeds) const;
+    
+    // Define clickable areas
+    juce::Rectangle<int> area1 {93, 330, 31, 31};  // L
+    juce::Rectangle<int> area2 {206, 330, 31, 31}; // C
+    juce::Rectangle<int> area3 {319, 330, 31, 31}; // R
+    
+    // Define LED lights
+    juce::Rectangle<int> ledBoundsL {105, 341, 8, 8}; // L
+    juce::Rectangle<int> ledBoundsC {218, 341, 8, 8}; // C
+    juce::Rectangle<int> ledBoundsR {331, 341, 8, 8}; // R
+    
+    // Define the clickable areas for W/R
+    juce::Rectangle<int> rotationUp {510, 38, 17, 17}; // Rotation Up
+    juce::Rectangle<int> rotationDown {510, 106, 17, 17}; // Rotation Down
+    juce::Rectangle<int> widthUp {609, 143, 17, 17}; // Width Up
+    juce::Rectangle<int> widthDown {609, 211, 17, 17}; // Width Down
+    
+    //==========================================================================
+    // STEREO CORRLEATION METER LEDS
+    
+    juce::Rectangle<int> led1L {478, 255, 8, 8};
+    juce::Rectangle<int> led1R {478, 268, 8, 8};
+    
+    juce::Rectangle<int> led2L {493, 255, 8, 8};
+    juce::Rectangle<int> led2R {493, 268, 8, 8};
+    
+    juce::Rectangle<int> led3L {508, 255, 8, 8};
+    juce::Rectangle<int> led3R {508, 268, 8, 8};
+    
+    juce::Rectangle<int> led4L {523, 255, 8, 8};
+    juce::Rectangle<int> led4R {523, 268, 8, 8};
+    
+    juce::Rectangle<int> led5L {538, 255, 8, 8};
+    juce::Rectangle<int> led5R {538, 268, 8, 8};
+    
+    juce::Rectangle<int> led6L {553, 255, 8, 8};
+    juce::Rectangle<int> led6R {553, 268, 8, 8};
+    
+    juce::Rectangle<int> led7L {576, 255, 8, 8};
+    juce::Rectangle<int> led7R {576, 268, 8, 8};
+    
+    juce::Rectangle<int> led8L {591, 255, 8, 8};
+    juce::Rectangle<int> led8R {591, 268, 8, 8};
+    
+    juce::Rectangle<int> led9L {606, 255, 8, 8};
+    juce::Rectangle<int> led9R {606, 268, 8, 8};
+    
+    juce::Rectangle<int> led10L {621, 255, 8, 8};
+    juce::Rectangle<int> led10R {621, 268, 8, 8};
+    
+    juce::Rectangle<int> led11L {636, 255, 8, 8};
+    juce::Rectangle<int> led11R {636, 268, 8, 8};
+    
+    juce::Rectangle<int> led12L {651, 255, 8, 8};
+    juce::Rectangle<int> led12R {651, 268, 8, 8};
+    
+    std::vector<juce::Rectangle<int>> ledsL =
+    {
+        led1L, led2L, led3L, led4L, led5L, led6L,
+        led7L, led8L, led9L, led10L, led11L, led12L
+    };
+    
+    std::vector<juce::Rectangle<int>> ledsR =
+    {
+        led1R, led2R, led3R, led4R, led5R, led6R,
+        led7R, led8R, led9R, led10R, led11R, led12R
+    };
+    
+    juce::Rectangle<int> correlationLedArea = led1L.getUnion(led12R);
+    
+    // Debug overlay with processBlock timings, toggled with alt-click
+    bool showPerformanceOverlay = false;
+    juce::Rectangle<int> performanceOverlayArea {8, 8, 260, 78};
+    
+    // Loudness, true-peak and mid/side readout, toggled from the scope menu
+    bool showLoudness = false;
+    juce::Rectangle<int> loudnessArea {8, 90, 200, 78};
+    void drawLoudness(juce::Graphics& g) const;
+    
+    // Correlation of each multiband width band, toggled from the scope menu
+    bool showBandCorrelation = false;
+    juce::Rectangle<int> bandCorrelationArea {8, 172, 200, 66};
+    void drawBandCorrelation(juce::Graphics& g) const;
+    
+    // W/R readouts
+    juce::Rectangle<int> widthReadout {593, 172, 50, 26};
+    juce::Rectangle<int> rotationReadout {493, 68, 50, 26};
+    
+    std::atomic<float>& correlationValue;
+    juce::SmoothedValue<float> smoothedCorrelation { 0.0f };
+    float displayVal = 0.0f;
+    
+    //==========================================================================
+    // What is currently on screen. refresh() compares against it and only
+    // invalidates the parts whose displayed value actually changed.
+    struct DisplayState
+    {
+        bool soloLeft = false, soloCenter = false, soloRight = false;
+        int correlationLeds = 0; // Lit LEDs, negative for the out-of-phase side
+        int rotation = 0, width = 100;
+    };
+    
+    DisplayState shown;
+    DisplayState readDisplayState() const;
+    
+    // Last, so it is gone before anything refresh() touches
+    juce::VBlankAttachment vBlank { this, [this](double timestampSeconds) { refresh(timestampSeconds); } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VectorScopeAudioProcessorEditor)
+};
@@ -1,282 +1,453 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#include "PluginProcessor.h"
-#include "PluginEditor.h"
-
-//==============================================================================
-VectorScopeAudioProcessor::VectorScopeAudioProcessor()
-#ifndef JucePlugin_PreferredChannelConfigurations
-     : AudioProcessor (BusesProperties()
-                     #if ! JucePlugin_IsMidiEffect
-                      #if ! JucePlugin_IsSynth
-                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
-                      #endif
-                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
-                     #endif
-                       ), apvts(*this, nullptr, "Diamond Imager Params", createParameterLayout())
-#endif
-{
-    processorBuffer.setSize(2, bufferSize);
-    processorBuffer.clear();
-    
-    ledOnLParam = apvts.getRawParameterValue("soloLeft");
-    ledOnCParam = apvts.getRawParameterValue("soloCenter");
-    ledOnRParam = apvts.getRawParameterValue("soloRight");
-}
-
-VectorScopeAudioProcessor::~VectorScopeAudioProcessor()
-{
-}
-
-//==============================================================================
-const juce::String VectorScopeAudioProcessor::getName() const
-{
-    return JucePlugin_Name;
-}
-
-bool VectorScopeAudioProcessor::acceptsMidi() const
-{
-   #if JucePlugin_WantsMidiInput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool VectorScopeAudioProcessor::producesMidi() const
-{
-   #if JucePlugin_ProducesMidiOutput
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-bool VectorScopeAudioProcessor::isMidiEffect() const
-{
-   #if JucePlugin_IsMidiEffect
-    return true;
-   #else
-    return false;
-   #endif
-}
-
-double VectorScopeAudioProcessor::getTailLengthSeconds() const
-{
-    return 0.0;
-}
-
-int VectorScopeAudioProcessor::getNumPrograms()
-{
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
-}
-
-int VectorScopeAudioProcessor::getCurrentProgram()
-{
-    return 0;
-}
-
-void VectorScopeAudioProcessor::setCurrentProgram (int index)
-{
-}
-
-const juce::String VectorScopeAudioProcessor::getProgramName (int index)
-{
-    return {};
-}
-
-void VectorScopeAudioProcessor::changeProgramName (int index, const juce::String& newName)
-{
-}
-
-//==============================================================================
-void VectorScopeAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
-{
-    processorBuffer.clear();
-    writePosition = 0;
-}
-
-void VectorScopeAudioProcessor::releaseResources()
-{
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
-}
-
-#ifndef JucePlugin_PreferredChannelConfigurations
-bool VectorScopeAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
-{
-  #if JucePlugin_IsMidiEffect
-    juce::ignoreUnused (layouts);
-    return true;
-  #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
-        return false;
-
-    // This checks if the input layout matches the output layout
-   #if ! JucePlugin_IsSynth
-    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
-        return false;
-   #endif
-
-    return true;
-  #endif
-}
-#endif
-
-void VectorScopeAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
-{
-    juce::ScopedNoDenormals noDenormals;
-    auto numSamples = buffer.getNumSamples();
-    auto numChannels = buffer.getNumChannels();
-
-    // Ensure we have at least 1 channel
-    if (numChannels == 0)
-    {
-        DBG("!!! WARNING: NUMCHANNELS == 0 !!!");
-        return;
-    }
-
-    auto* leftChannel = buffer.getWritePointer(0); // Always use channel 0
-    auto* rightChannel = (numChannels > 1) ? buffer.getWritePointer(1) : leftChannel; // Use left for mono
-    
-
-    bool soloLeft = *ledOnLParam > 0.5f;   // Treat as bool (0.0f = false, 1.0f = true)
-    bool soloCenter = *ledOnCParam > 0.5f;
-    bool soloRight = *ledOnRParam > 0.5f;
-    bool anySoloActive = soloLeft || soloCenter || soloRight;
-
-    if (anySoloActive)
-    {
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            float leftSample = leftChannel[sample];
-            float rightSample = (numChannels > 1) ? rightChannel[sample] : leftSample;
-            float centerSample = (leftSample + rightSample) * 0.5f;
-
-            float leftOutput = 0.0f;
-            float rightOutput = 0.0f;
-
-            if (soloLeft) leftOutput += leftSample;
-            if (soloCenter && !soloLeft && !soloRight)
-            {
-                leftOutput += centerSample;
-                rightOutput += centerSample;
-            }
-            if (soloRight) rightOutput += rightSample;
-
-            leftChannel[sample] = leftOutput;
-            if (numChannels > 1) rightChannel[sample] = rightOutput;
-        }
-    }
-    
-    pushSamplesToEditor(leftChannel, rightChannel, numSamples);
-    
-    correlationValue.store(calculateStereoCorrelation(leftChannel, rightChannel, numSamples));
-    
-    // Clear unused output channels if more outputs than inputs
-    for (int channel = numChannels; channel < getTotalNumOutputChannels(); ++channel)
-    {
-        buffer.clear(channel, 0, numSamples);
-    }
-    
-#if JUCE_DEBUG
-    protectYourEars(buffer);
-#endif
-}
-
-void VectorScopeAudioProcessor::pushSamplesToEditor(const float* leftSamples, const float* rightSamples, int numSamples)
-{
-    int samplesToWrite = juce::jmin(numSamples, bufferSize - writePosition);
-
-    // Copy to processorBuffer, duplicating mono to both channels
-    for (int i = 0; i < samplesToWrite; ++i)
-    {
-        processorBuffer.setSample(0, writePosition + i, leftSamples[i]);
-        processorBuffer.setSample(1, writePosition + i, (leftSamples == rightSamples) ? leftSamples[i] : rightSamples[i]);
-    }
-
-    writePosition += samplesToWrite;
-
-    if (writePosition >= bufferSize)
-    {
-        if (auto* editor = dynamic_cast<VectorScopeAudioProcessorEditor*>(getActiveEditor()))
-        {
-            editor->pushSamples(processorBuffer.getReadPointer(0), processorBuffer.getReadPointer(1), bufferSize);
-        }
-        writePosition = 0;
-    }
-}
-//==============================================================================
-bool VectorScopeAudioProcessor::hasEditor() const
-{
-    return true; // (change this to false if you choose to not supply an editor)
-}
-
-juce::AudioProcessorEditor* VectorScopeAudioProcessor::createEditor()
-{
-    return new VectorScopeAudioProcessorEditor (*this, correlationValue);
-}
-
-//==============================================================================
-void VectorScopeAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
-{
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
-}
-
-void VectorScopeAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
-{
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-}
-
-juce::AudioProcessorValueTreeState::ParameterLayout VectorScopeAudioProcessor::createParameterLayout()
-{
-    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
-    
-    auto soloLParamID = juce::ParameterID("soloLeft", 1);
-    auto soloCParamID = juce::ParameterID("soloCenter", 1);
-    auto soloRParamID = juce::ParameterID("soloRight", 1);
-    
-    params.push_back(std::make_unique<juce::AudioParameterBool>(soloLParamID, "Solo Left", false));
-    params.push_back(std::make_unique<juce::AudioParameterBool>(soloCParamID, "Solo Center", false));
-    params.push_back(std::make_unique<juce::AudioParameterBool>(soloRParamID, "Solo Right", false));
-    
-    return {    params.begin(), params.end()    };
-}
-
-float VectorScopeAudioProcessor::calculateStereoCorrelation(const float *left, const float *right, int numSamples)
-{
-    if (numSamples <= 0) return 1.0f;
-    
-    double sumLL = 0.0, sumRR = 0.0, sumLR = 0.0;
-    
-    for (int i = 0; i < numSamples; ++i)
-    {
-        sumLL += left[i] * left[i];
-        sumRR += right[i] * right[i];
-        sumLR += left[i] * right[i];
-    }
-    
-    double denom = std::sqrt(sumLL * sumRR);
-    if (denom == 0.0) return 0.0f;
-    
-    return static_cast<float>(sumLR / denom);
-    
-}
-
-//==============================================================================
-// This creates new instances of the plugin..
-juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
-{
-    return new VectorScopeAudioProcessor();
-}
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+namespace
+{
+    // Tempo-synced rotation: one LFO cycle per entry, in quarter notes
+    const juce::StringArray rotationRateNames { "1/4", "1/2", "1 Bar", "2 Bars", "4 Bars", "8 Bars" };
+    constexpr double rotationRateQuarterNotes[] { 1.0, 2.0, 4.0, 8.0, 16.0, 32.0 };
+    
+    // Saved state: "DIMG", a format version, then the APVTS and snapshot trees
+    // in ValueTree's binary encoding
+    constexpr int stateMagic = 0x474d4944;
+    constexpr int stateVersion = 1;
+    
+    // The decimated scope points go to the editor and, when it is on, the
+    // shared memory export
+    struct ScopeOutputs
+    {
+        ScopeFifo& fifo;
+        SharedMemoryExport& shared;
+        
+        template <typename SampleType>
+        void push(const SampleType* left, const SampleType* right, int numSamples)
+        {
+            fifo.push(left, right, numSamples);
+            shared.push(left, right, numSamples);
+        }
+        
+        void setPointsPerWindow(int numPoints)
+        {
+            fifo.setPointsPerWindow(numPoints);
+            shared.setPointsPerWindow(numPoints);
+        }
+    };
+}
+
+//==============================================================================
+VectorScopeAudioProcessor::VectorScopeAudioProcessor()
+#ifndef JucePlugin_PreferredChannelConfigurations
+     : AudioProcessor (BusesProperties()
+                     #if ! JucePlugin_IsMidiEffect
+                      #if ! JucePlugin_IsSynth
+                       .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                      #endif
+                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                     #endif
+                       ), apvts(*this, nullptr, "Diamond Imager Params", createParameterLayout()),
+                         parameterSnapshots(apvts)
+#endif
+{
+    ledOnLParam = apvts.getRawParameterValue("soloLeft");
+    ledOnCParam = apvts.getRawParameterValue("soloCenter");
+    ledOnRParam = apvts.getRawParameterValue("soloRight");
+    rotationParam = apvts.getRawParameterValue("rotation");
+    widthParam = apvts.getRawParameterValue("width");
+    rotationSyncParam = apvts.getRawParameterValue("rotationSync");
+    bandsParam = apvts.getRawParameterValue("bands");
+    
+    jassert(parameterSnapshots.getNumParameters() == numParameters);
+    jassert(parameterSnapshots.getParameterID(bandsIndex) == "bands");
+    jassert(parameterSnapshots.getParameterID(widthBand1Index) == "widthBand1");
+}
+
+VectorScopeAudioProcessor::~VectorScopeAudioProcessor()
+{
+}
+
+//==============================================================================
+const juce::String VectorScopeAudioProcessor::getName() const
+{
+    return JucePlugin_Name;
+}
+
+bool VectorScopeAudioProcessor::acceptsMidi() const
+{
+   #if JucePlugin_WantsMidiInput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool VectorScopeAudioProcessor::producesMidi() const
+{
+   #if JucePlugin_ProducesMidiOutput
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+bool VectorScopeAudioProcessor::isMidiEffect() const
+{
+   #if JucePlugin_IsMidiEffect
+    return true;
+   #else
+    return false;
+   #endif
+}
+
+double VectorScopeAudioProcessor::getTailLengthSeconds() const
+{
+    return 0.0;
+}
+
+int VectorScopeAudioProcessor::getNumPrograms()
+{
+    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                // so this should be at least 1, even if you're not really implementing programs.
+}
+
+int VectorScopeAudioProcessor::getCurrentProgram()
+{
+    return 0;
+}
+
+void VectorScopeAudioProcessor::setCurrentProgram (int index)
+{
+}
+
+const juce::String VectorScopeAudioProcessor::getProgramName (int index)
+{
+    return {};
+}
+
+void VectorScopeAudioProcessor::changeProgramName (int index, const juce::String& newName)
+{
+}
+
+//==============================================================================
+void VectorScopeAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
+{
+    stereoMatrix.setParameters(rotationParam->load(), widthParam->load(), rotationSyncParam->load() > 0.5f);
+    stereoMatrix.prepare(sampleRate);
+    rotationLfo.prepare(sampleRate);
+    multibandWidth.prepare(sampleRate);
+    
+    correlationMeter.prepare(sampleRate);
+    sharedMemoryExport.prepare(sampleRate);
+    scopeDecimator.prepare(sampleRate);
+    earProtection.prepare(sampleRate);
+    correlationMatrix.prepare(sampleRate);
+    spectralCorrelation.prepare(sampleRate);
+    parameterSnapshots.prepare(sampleRate);
+}
+
+void VectorScopeAudioProcessor::releaseResources()
+{
+    // When playback stops, you can use this as an opportunity to free up any
+    // spare memory, etc.
+    spectralCorrelation.release();
+}
+
+#ifndef JucePlugin_PreferredChannelConfigurations
+bool VectorScopeAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
+{
+  #if JucePlugin_IsMidiEffect
+    juce::ignoreUnused (layouts);
+    return true;
+  #else
+    const juce::AudioChannelSet supported[] =
+    {
+        juce::AudioChannelSet::mono(),
+        juce::AudioChannelSet::stereo(),
+        juce::AudioChannelSet::create5point0(),
+        juce::AudioChannelSet::create5point1(),
+        juce::AudioChannelSet::create7point0(),
+        juce::AudioChannelSet::create7point1(),
+        juce::AudioChannelSet::create7point1point4()
+    };
+    
+    if (std::find(std::begin(supported), std::end(supported), layouts.getMainOutputChannelSet()) == std::end(supported))
+        return false;
+
+    // This checks if the input layout matches the output layout
+   #if ! JucePlugin_IsSynth
+    if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
+        return false;
+   #endif
+
+    return true;
+  #endif
+}
+#endif
+
+void VectorScopeAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples(buffer);
+}
+
+void VectorScopeAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processSamples(buffer);
+}
+
+template <typename SampleType>
+void VectorScopeAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer)
+{
+    juce::ScopedNoDenormals noDenormals;
+    PerformanceMonitor::ScopedBlock measureBlock(performanceMonitor, getSampleRate(), buffer.getNumSamples());
+    
+    auto numSamples = buffer.getNumSamples();
+    auto numChannels = buffer.getNumChannels();
+
+    // Ensure we have at least 1 channel
+    if (numChannels == 0)
+        return;
+
+    // Live parameter values, or a recalled snapshot's complete set
+    const auto& parameters = parameterSnapshots.beginBlock();
+    
+    auto* leftChannel = buffer.getWritePointer(0); // Always use channel 0
+    auto* rightChannel = (numChannels > 1) ? buffer.getWritePointer(1) : leftChannel; // Use left for mono
+    
+    // Width, rotation and solo act on the front L/R pair, which is channels 0 and 1
+    // in every supported layout; surround channels pass through untouched. JUCE
+    // gives parameter changes no sample position, so they all apply from the
+    // start of the block.
+    if (numChannels > 1)
+    {
+        multibandWidth.setParameters(static_cast<int>(parameters[bandsIndex]),
+                                     parameters.data() + crossover1Index, parameters.data() + widthBand1Index);
+        multibandWidth.process(leftChannel, rightChannel, numSamples);
+        
+        auto rate = juce::jlimit(0, (int) std::size(rotationRateQuarterNotes) - 1, static_cast<int>(parameters[rotationRateIndex]));
+        rotationLfo.setCycleLength(rotationRateQuarterNotes[rate]);
+        rotationLfo.sync(getPlayHead());
+        
+        stereoMatrix.setParameters(parameters[rotationIndex], parameters[widthIndex], parameters[rotationSyncIndex] > 0.5f);
+        
+        if (parameterSnapshots.hasJumped())
+            stereoMatrix.snapToTarget();
+        
+        stereoMatrix.process(leftChannel, rightChannel, numSamples, rotationLfo);
+    }
+
+    bool soloLeft = parameters[soloLeftIndex] > 0.5f;   // Treat as bool (0.0f = false, 1.0f = true)
+    bool soloCenter = parameters[soloCenterIndex] > 0.5f;
+    bool soloRight = parameters[soloRightIndex] > 0.5f;
+
+    // Resolve the solo combination once, then run its specialised kernel over the whole block
+    SoloMatrix::process(SoloMatrix::getMode(soloLeft, soloCenter, soloRight), leftChannel, rightChannel, numSamples);
+    
+    parameterSnapshots.applyFade(buffer);
+    
+    // Guard before the analysis so a bad block can't poison the meters' running sums
+    earProtection.process(buffer);
+    
+    // The scope and the meter follow the selected pair (L/R unless chosen otherwise)
+    int channelA = juce::jmin(analysisChannelA.load(), numChannels - 1);
+    int channelB = juce::jmin(analysisChannelB.load(), numChannels - 1);
+    auto* analysisA = buffer.getReadPointer(channelA);
+    auto* analysisB = buffer.getReadPointer(channelB);
+    
+    sharedMemoryExport.beginBlock();
+    pushSamplesToEditor(analysisA, analysisB, numSamples);
+    spectralCorrelation.push(analysisA, analysisB, numSamples);
+    
+    if (numChannels > 2)
+        correlationMatrix.process(buffer.getArrayOfReadPointers(), numChannels, numSamples);
+    
+    if (loudnessResetPending.exchange(false))
+        correlationMeter.resetLoudness();
+    
+    correlationMeter.process(analysisA, analysisB, numSamples);
+    correlationValue.store(correlationMeter.getCorrelation(CorrelationMeter::slow));
+    correlationFastValue.store(correlationMeter.getCorrelation(CorrelationMeter::fast));
+    correlationIntegratedValue.store(correlationMeter.getIntegratedCorrelation());
+    momentaryLoudness.store(correlationMeter.getMomentaryLoudness());
+    shortTermLoudness.store(correlationMeter.getShortTermLoudness());
+    integratedLoudness.store(correlationMeter.getIntegratedLoudness());
+    truePeakLeft.store(correlationMeter.getTruePeak(0));
+    truePeakRight.store(correlationMeter.getTruePeak(1));
+    midSideRatio.store(correlationMeter.getMidSideRatio());
+    
+    SharedMemoryExport::Meters meters;
+    meters.correlation = correlationValue.load();
+    meters.correlationFast = correlationFastValue.load();
+    meters.correlationIntegrated = correlationIntegratedValue.load();
+    meters.momentaryLoudness = momentaryLoudness.load();
+    meters.shortTermLoudness = shortTermLoudness.load();
+    meters.integratedLoudness = integratedLoudness.load();
+    meters.truePeakLeft = truePeakLeft.load();
+    meters.truePeakRight = truePeakRight.load();
+    meters.midSideRatio = midSideRatio.load();
+    sharedMemoryExport.endBlock(meters);
+    
+    // Clear unused output channels if more outputs than inputs
+    for (int channel = numChannels; channel < getTotalNumOutputChannels(); ++channel)
+    {
+        buffer.clear(channel, 0, numSamples);
+    }
+}
+
+void VectorScopeAudioProcessor::setAnalysisPair(int channelA, int channelB)
+{
+    analysisChannelA.store(juce::jmax(0, channelA));
+    analysisChannelB.store(juce::jmax(0, channelB));
+}
+
+template <typename SampleType>
+void VectorScopeAudioProcessor::pushSamplesToEditor(const SampleType* leftSamples, const SampleType* rightSamples, int numSamples)
+{
+    // Mono arrives as leftSamples == rightSamples, which the scope draws as a centred line
+    ScopeOutputs outputs { scopeFifo, sharedMemoryExport };
+    scopeDecimator.process(leftSamples, rightSamples, numSamples, outputs);
+}
+
+// Instantiated here for the tools, which feed the scope path directly
+template void VectorScopeAudioProcessor::pushSamplesToEditor<float>(const float*, const float*, int);
+template void VectorScopeAudioProcessor::pushSamplesToEditor<double>(const double*, const double*, int);
+
+//==============================================================================
+bool VectorScopeAudioProcessor::hasEditor() const
+{
+    return true; // (change this to false if you choose to not supply an editor)
+}
+
+juce::AudioProcessorEditor* VectorScopeAudioProcessor::createEditor()
+{
+    return new VectorScopeAudioProcessorEditor (*this, correlationValue);
+}
+
+//==============================================================================
+void VectorScopeAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    // Binary rather than XML: smaller, and much quicker to parse when a
+    // session recalls many instances at once
+    juce::MemoryOutputStream stream(destData, false);
+    stream.writeInt(stateMagic);
+    stream.writeInt(stateVersion);
+    apvts.copyState().writeToStream(stream);
+    parameterSnapshots.toValueTree().writeToStream(stream);
+}
+
+void VectorScopeAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    juce::MemoryInputStream stream(data, (size_t) sizeInBytes, false);
+    
+    // Unknown data, or written by a newer version we can't know the layout of
+    if (sizeInBytes < 8 || stream.readInt() != stateMagic || stream.readInt() > stateVersion)
+        return;
+    
+    auto state = juce::ValueTree::readFromStream(stream);
+    if (state.hasType(apvts.state.getType()))
+        apvts.replaceState(state);
+    
+    parameterSnapshots.fromValueTree(juce::ValueTree::readFromStream(stream));
+}
+
+void VectorScopeAudioProcessor::updateTrackProperties (const TrackProperties& properties)
+{
+    sharedMemoryExport.setName(properties.name.value_or(juce::String()));
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout VectorScopeAudioProcessor::createParameterLayout()
+{
+    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
+    
+    auto soloLParamID = juce::ParameterID("soloLeft", 1);
+    auto soloCParamID = juce::ParameterID("soloCenter", 1);
+    auto soloRParamID = juce::ParameterID("soloRight", 1);
+    auto rotationParamID = juce::ParameterID("rotation", 1);
+    auto widthParamID = juce::ParameterID("width", 1);
+    
+    params.push_back(std::make_unique<juce::AudioParameterBool>(soloLParamID, "Solo Left", false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(soloCParamID, "Solo Center", false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>(soloRParamID, "Solo Right", false));
+    
+    // Same ranges the W/R readouts have always shown: degrees and percent
+    params.push_back(std::make_unique<juce::AudioParameterInt>(rotationParamID, "Rotation", 0, 100, 0,
+                                                               juce::AudioParameterIntAttributes().withLabel("deg")));
+    params.push_back(std::make_unique<juce::AudioParameterInt>(widthParamID, "Width", 0, 200, 100,
+                                                               juce::AudioParameterIntAttributes().withLabel("%")));
+    
+    // With sync on, rotation sets the depth of a sine locked to the host tempo
+    params.push_back(std::make_unique<juce::AudioParameterBool>(juce::ParameterID("rotationSync", 1), "Rotation Sync", false));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID("rotationRate", 1), "Rotation Rate", rotationRateNames, 2));
+    
+    // Multiband width: one band leaves the signal unsplit
+    params.push_back(std::make_unique<juce::AudioParameterInt>(juce::ParameterID("bands", 1), "Bands", 1, MultibandWidth::maxBands, 1));
+    
+    const float defaultCrossovers[] = { 120.0f, 1000.0f, 6000.0f };
+    for (int i = 0; i < MultibandWidth::maxBands - 1; ++i)
+    {
+        juce::NormalisableRange<float> range(20.0f, 20000.0f, 1.0f);
+        range.setSkewForCentre(1000.0f);
+        
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("crossover" + juce::String(i + 1), 1),
+                                                                     "Crossover " + juce::String(i + 1), range, defaultCrossovers[i],
+                                                                     juce::AudioParameterFloatAttributes().withLabel("Hz")));
+    }
+    
+    for (int band = 0; band < MultibandWidth::maxBands; ++band)
+        params.push_back(std::make_unique<juce::AudioParameterInt>(juce::ParameterID("widthBand" + juce::String(band + 1), 1),
+                                                                   "Width Band " + juce::String(band + 1), 0, 200, 100,
+                                                                   juce::AudioParameterIntAttributes().withLabel("%")));
+    
+    return {    params.begin(), params.end()    };
+}
+
+float VectorScopeAudioProcessor::calculateStereoCorrelation(const float *left, const float *right, int numSamples)
+{
+    if (numSamples <= 0) return 1.0f;
+    
+    return sumStereoProducts(left, right, numSamples).getCorrelation();
+}
+
+VectorScopeAudioProcessor::StereoSums VectorScopeAudioProcessor::sumStereoProducts(const float* left, const float* right, int numSamples)
+{
+    StereoSums sums;
+    
+    for (int i = 0; i < numSamples; ++i)
+    {
+        sums.ll += left[i] * left[i];
+        sums.rr += right[i] * right[i];
+        sums.lr += left[i] * right[i];
+    }
+    
+    sums.numSamples = juce::jmax(0, numSamples);
+    return sums;
+}
+
+void VectorScopeAudioProcessor::StereoSums::add(const StereoSums& other)
+{
+    ll += other.ll;
+    rr += other.rr;
+    lr += other.lr;
+    numSamples += other.numSamples;
+}
+
+float VectorScopeAudioProcessor::StereoSums::getCorrelation() const
+{
+    double denom = std::sqrt(ll * rr);
+    if (denom == 0.0) return 0.0f;
+    
+    return static_cast<float>(juce::jlimit(-1.0, 1.0, lr / denom));
+}
+
+//==============================================================================
+// This creates new instances of the plugin..
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new VectorScopeAudioProcessor();
+}
@@ -1,78 +1,185 @@
-/*
-  ==============================================================================
-
-    This file contains the basic framework code for a JUCE plugin processor.
-
-  ==============================================================================
-*/
-
-#pragma once
-
-#include <JuceHeader.h>
-#include "ProtectYourEars.h"
-
-//==============================================================================
-/**
-*/
-class VectorScopeAudioProcessor  : public juce::AudioProcessor
-{
-public:
-    //==============================================================================
-    VectorScopeAudioProcessor();
-    ~VectorScopeAudioProcessor() override;
-
-    //==============================================================================
-    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
-    void releaseResources() override;
-
-   #ifndef JucePlugin_PreferredChannelConfigurations
-    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
-   #endif
-
-    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-
-    //==============================================================================
-    juce::AudioProcessorEditor* createEditor() override;
-    bool hasEditor() const override;
-
-    //==============================================================================
-    const juce::String getName() const override;
-
-    bool acceptsMidi() const override;
-    bool producesMidi() const override;
-    bool isMidiEffect() const override;
-    double getTailLengthSeconds() const override;
-
-    //==============================================================================
-    int getNumPrograms() override;
-    int getCurrentProgram() override;
-    void setCurrentProgram (int index) override;
-    const juce::String getProgramName (int index) override;
-    void changeProgramName (int index, const juce::String& newName) override;
-
-    //==============================================================================
-    void getStateInformation (juce::MemoryBlock& destData) override;
-    void setStateInformation (const void* data, int sizeInBytes) override;
-    
-    //================================
-    void pushSamplesToEditor(const float* leftSamples, const float* rightSamples, int numSamples);
-    
-    juce::AudioProcessorValueTreeState apvts;
-    
-    std::atomic<float>* ledOnLParam = nullptr;
-    std::atomic<float>* ledOnCParam = nullptr;
-    std::atomic<float>* ledOnRParam = nullptr;
-    
-    std::atomic<float> correlationValue { 0.0f };
-    
-    float calculateStereoCorrelation (const float* left, const float* right, int numSamples);
-
-private:
-    juce::AudioBuffer<float> processorBuffer;
-    int writePosition = 0;
-    static constexpr int bufferSize = 1024;
-    
-    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
-    //==============================================================================
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VectorScopeAudioProcessor)
-};
+/*
+  ==============================================================================
+
+    This file contains the basic framework code for a JUCE plugin processor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ProtectYourEars.h"
+#include "ScopeFifo.h"
+#include "ScopeDecimator.h"
+#include "SoloMatrix.h"
+#include "StereoMatrix.h"
+#include "MultibandWidth.h"
+#include "CorrelationMeter.h"
+#include "CorrelationMatrix.h"
+#include "SpectralCorrelation.h"
+#include "PerformanceMonitor.h"
+#include "ParameterSnapshots.h"
+#include "SharedMemoryExport.h"
+
+//==============================================================================
+/**
+*/
+class VectorScopeAudioProcessor  : public juce::AudioProcessor
+{
+public:
+    //==============================================================================
+    VectorScopeAudioProcessor();
+    ~VectorScopeAudioProcessor() override;
+
+    //==============================================================================
+    void prepareToPlay (double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+
+   #ifndef JucePlugin_PreferredChannelConfigurations
+    bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
+   #endif
+
+    void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    
+    // Both precisions run the same templated code, so a 64-bit host doesn't
+    // have to convert around us
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    //==============================================================================
+    const juce::String getName() const override;
+
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    //==============================================================================
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+
+    //==============================================================================
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+    
+    // The track name goes into the shared memory export, for the monitor
+    void updateTrackProperties (const TrackProperties& properties) override;
+    
+    //================================
+    template <typename SampleType>
+    void pushSamplesToEditor(const SampleType* leftSamples, const SampleType* rightSamples, int numSamples);
+    
+    juce::AudioProcessorValueTreeState apvts;
+    
+    // A/B snapshots of every parameter, switched with a short dip
+    ParameterSnapshots parameterSnapshots;
+    
+    // Position of each parameter in createParameterLayout(), which is also the
+    // order ParameterSnapshots hands them to processBlock in
+    enum ParameterIndex
+    {
+        soloLeftIndex, soloCenterIndex, soloRightIndex,
+        rotationIndex, widthIndex, rotationSyncIndex, rotationRateIndex,
+        bandsIndex,
+        crossover1Index,
+        widthBand1Index = crossover1Index + MultibandWidth::maxBands - 1,
+        numParameters = widthBand1Index + MultibandWidth::maxBands
+    };
+    
+    std::atomic<float>* ledOnLParam = nullptr;
+    std::atomic<float>* ledOnCParam = nullptr;
+    std::atomic<float>* ledOnRParam = nullptr;
+    std::atomic<float>* rotationParam = nullptr;
+    std::atomic<float>* widthParam = nullptr;
+    std::atomic<float>* rotationSyncParam = nullptr;
+    std::atomic<float>* bandsParam = nullptr;
+    
+    std::atomic<float> correlationValue { 0.0f };            // slow (300 ms), drives the LED meter
+    std::atomic<float> correlationFastValue { 0.0f };        // fast (50 ms)
+    std::atomic<float> correlationIntegratedValue { 0.0f };  // since the last prepareToPlay
+    
+    // Loudness (LUFS), true-peak (dBTP) and mid/side ratio (dB) of the analysis pair
+    std::atomic<float> momentaryLoudness { CorrelationMeter::minimumLevel };
+    std::atomic<float> shortTermLoudness { CorrelationMeter::minimumLevel };
+    std::atomic<float> integratedLoudness { CorrelationMeter::minimumLevel };
+    std::atomic<float> truePeakLeft { CorrelationMeter::minimumLevel };
+    std::atomic<float> truePeakRight { CorrelationMeter::minimumLevel };
+    std::atomic<float> midSideRatio { 0.0f };
+    
+    // Restarts integrated loudness and the true-peak hold at the next block
+    void resetLoudness() { loudnessResetPending.store(true); }
+    
+    // Which two channels of the bus the scope and the correlation meter follow.
+    // Defaults to L/R; on surround buses any pair can be picked.
+    void setAnalysisPair(int channelA, int channelB);
+    std::pair<int, int> getAnalysisPair() const { return { analysisChannelA.load(), analysisChannelB.load() }; }
+    
+    // Every channel pair of surround buses (300 ms), updated while it is enabled
+    // and there are more than two channels
+    CorrelationMatrix correlationMatrix;
+    
+    // Per-band correlation/phase of the analysis pair, computed on its own thread while enabled
+    SpectralCorrelation spectralCorrelation;
+    
+    // Per-band width ahead of the global matrix; its per-band correlation is shown by the editor
+    MultibandWidth multibandWidth;
+    
+    // Per-block cost against the real-time budget, readable from any thread
+    PerformanceMonitor performanceMonitor;
+    
+    // Output guard; its event counters are polled by the editor
+    ProtectYourEars earProtection;
+    
+    // Drained by the vectorscope on the message thread
+    ScopeFifo scopeFifo;
+    
+    // Optional copy of the scope points and meters for an external monitor
+    SharedMemoryExport sharedMemoryExport;
+    
+    // Scope span and how many points it is drawn with, independent of sample rate
+    void setScopeWindow(float milliseconds)     { scopeDecimator.setWindow(milliseconds); }
+    void setScopePointBudget(int numPoints)     { scopeDecimator.setPointBudget(numPoints); }
+    float getScopeWindow() const                { return scopeDecimator.getWindow(); }
+    int getScopePointBudget() const             { return scopeDecimator.getPointBudget(); }
+    
+    // Sums of L*L, R*R and L*R over a stretch of samples. Sums of adjacent
+    // stretches add up, so long files can be reduced in parallel windows.
+    struct StereoSums
+    {
+        double ll = 0.0, rr = 0.0, lr = 0.0;
+        juce::int64 numSamples = 0;
+        
+        void add(const StereoSums& other);
+        float getCorrelation() const; // 0 if either side is silent
+    };
+    
+    // The one reduction behind calculateStereoCorrelation, also used by the
+    // batch analyser so a file and the plugin agree on the same audio
+    static StereoSums sumStereoProducts (const float* left, const float* right, int numSamples);
+    
+    float calculateStereoCorrelation (const float* left, const float* right, int numSamples);
+
+private:
+    StereoMatrix stereoMatrix;
+    TempoSyncedLfo rotationLfo;
+    CorrelationMeter correlationMeter;
+    ScopeDecimator scopeDecimator;
+    
+    std::atomic<int> analysisChannelA { 0 }, analysisChannelB { 1 };
+    std::atomic<bool> loudnessResetPending { false };
+    
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer);
+    
+    juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VectorScopeAudioProcessor)
+};
@@ -10,49 +10,152 @@
 
 #pragma once
 
-inline void protectYourEars(juce::AudioBuffer<float>& buffer)
+// Last line of defence before the output, active in release builds too.
+// Each channel gets one fused min/max/non-finite reduction per block. A
+// channel that contains NaN or infinity is faded out up to the first bad
+// sample and muted from there, then faded back in on its next clean block;
+// the other channels keep playing. Nothing here allocates or logs, events
+// are counted in atomics for the UI to poll.
+class ProtectYourEars
 {
-    bool firstWarning = true;
-    
-    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+public:
+    void prepare(double sampleRate)
     {
-        
-        float* channelData = buffer.getWritePointer(channel);
-        
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        rampLength = juce::jmax(1, juce::roundToInt(sampleRate * 0.002)); // 2 ms
+        muted.fill(false);
+    }
+
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer)
+    {
+        int numSamples = buffer.getNumSamples();
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
         {
-            float x = channelData[sample];
-            bool silence = false;
-            
-            if (std::isnan(x))
-            {
-                DBG("!!! WARNING: NAN DETECTED IN AUDIO BUFFER, SILENCING NOW... !!!");
-                silence = true;
-            }
-            else if (std::isinf(x))
-            {
-                DBG("!!! WARNING: INFINITY DETECTED IN AUDIO BUFFER, SILENCING NOW... !!!");
-                silence = true;
-            }
-            else if (x < -2.0f || x > 2.0f)
-            {
-                DBG("!!! WARNING: SAMPLE OUT OF RANGE, SILENCING NOW... !!!");
-            }
-            else if (x < -1.0f || x > 1.0f)
+            SampleType* channelData = buffer.getWritePointer(channel);
+            auto scan = scanChannel(channelData, numSamples);
+            bool& channelMuted = muted[(size_t) juce::jmin(channel, maxChannels - 1)];
+
+            if (! scan.finite)
             {
-                if (firstWarning)
+                if (! channelMuted)
                 {
-                    DBG("!!! WARNING: SAMPLE OUT OF RANGE, SILENCING NOW... !!!");
-                    firstWarning = false;
+                    // Only reached on the event itself, so a scalar search is fine
+                    int firstBad = 0;
+                    while (firstBad < numSamples && isFinite(channelData[firstBad]))
+                        ++firstBad;
+
+                    int rampStart = juce::jmax(0, firstBad - rampLength);
+                    if (firstBad > rampStart)
+                        buffer.applyGainRamp(channel, rampStart, firstBad - rampStart, SampleType(1), SampleType(0));
+
+                    buffer.clear(channel, firstBad, numSamples - firstBad);
                 }
+                else
+                {
+                    buffer.clear(channel, 0, numSamples);
+                }
+
+                channelMuted = true;
+                nonFiniteEvents.fetch_add(1, std::memory_order_relaxed);
+                continue;
             }
-            if (silence)
+
+            if (scan.peak > 2.0f) // +6 dBFS
+                overloadEvents.fetch_add(1, std::memory_order_relaxed);
+
+            if (channelMuted)
             {
-                buffer.clear();
-                return;
+                buffer.applyGainRamp(channel, 0, juce::jmin(rampLength, numSamples), SampleType(0), SampleType(1));
+                channelMuted = false;
             }
-            
         }
-        
     }
-}
+
+    // Blocks in which a channel had to be muted because of NaN / infinity
+    std::atomic<juce::uint32> nonFiniteEvents { 0 };
+    // Blocks in which a channel peaked above +6 dBFS (reported, not muted)
+    std::atomic<juce::uint32> overloadEvents { 0 };
+
+private:
+    struct Scan
+    {
+        bool finite = true;
+        float peak = 0.0f;
+    };
+
+    // 1 if the exponent bits are all ones, i.e. for NaN or infinity. Tested
+    // on the bits rather than with std::isfinite or x * 0, which -ffast-math
+    // and /fp:fast are free to fold away by assuming every value is finite.
+    template <typename SampleType>
+    static juce::uint32 nonFiniteBit(SampleType x)
+    {
+        if constexpr (sizeof(SampleType) == 4)
+        {
+            juce::uint32 bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+            return (bits & 0x7f800000u) == 0x7f800000u ? 1u : 0u;
+        }
+        else
+        {
+            juce::uint64 bits;
+            std::memcpy(&bits, &x, sizeof(bits));
+            return (bits & 0x7ff0000000000000ull) == 0x7ff0000000000000ull ? 1u : 0u;
+        }
+    }
+
+    template <typename SampleType>
+    static bool isFinite(SampleType x)
+    {
+        return nonFiniteBit(x) == 0;
+    }
+
+    // Eight lanes of min, max and a non-finite flag so the loop vectorises;
+    // once set, the flag sticks in its lane.
+    template <typename SampleType>
+    static Scan scanChannel(const SampleType* data, int numSamples)
+    {
+        constexpr int lanes = 8;
+        SampleType lo[lanes] = {}, hi[lanes] = {};
+        juce::uint32 bad[lanes] = {};
+
+        int i = 0;
+        for (; i + lanes <= numSamples; i += lanes)
+        {
+            for (int k = 0; k < lanes; ++k)
+            {
+                const SampleType x = data[i + k];
+                lo[k] = x < lo[k] ? x : lo[k];
+                hi[k] = x > hi[k] ? x : hi[k];
+                bad[k] |= nonFiniteBit(x);
+            }
+        }
+
+        for (int k = 0; i < numSamples; ++i, ++k)
+        {
+            const SampleType x = data[i];
+            lo[k] = x < lo[k] ? x : lo[k];
+            hi[k] = x > hi[k] ? x : hi[k];
+            bad[k] |= nonFiniteBit(x);
+        }
+
+        Scan scan;
+        SampleType peak = 0;
+        juce::uint32 anyBad = 0;
+
+        for (int k = 0; k < lanes; ++k)
+        {
+            peak = juce::jmax(peak, -lo[k], hi[k]);
+            anyBad |= bad[k];
+        }
+
+        scan.peak = static_cast<float>(peak);
+        scan.finite = (anyBad == 0);
+        return scan;
+    }
+
+    static constexpr int maxChannels = 64;
+
+    int rampLength = 88;
+    std::array<bool, maxChannels> muted {};
+};
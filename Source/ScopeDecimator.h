@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    ScopeDecimator.h
+    Created: 17 Oct 2026 12:55:45pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "ScopeFifo.h"
+
+// Reduces what the scope receives to a fixed number of points per time
+// window, whatever the sample rate. Runs on the audio thread before the FIFO:
+// each group of `factor` samples is replaced by its loudest (L, R) pair, so
+// peaks and the outline of the trace survive the decimation.
+class ScopeDecimator
+{
+public:
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        appliedWindowMs = -1.0f; // Forces updateFactor() on the next block
+        groupCount = 0;
+        bestEnergy = -1.0f;
+    }
+
+    // Message thread. Both are picked up at the start of the next block.
+    void setWindow(float milliseconds)  { windowMs.store(juce::jlimit(1.0f, 1000.0f, milliseconds)); }
+    void setPointBudget(int numPoints)  { pointBudget.store(juce::jlimit(64, ScopeFifo::maxPointsPerWindow, numPoints)); }
+
+    float getWindow() const      { return windowMs.load(); }
+    int getPointBudget() const   { return pointBudget.load(); }
+
+    // Output goes to anything with ScopeFifo's push() and setPointsPerWindow()
+    template <typename SampleType, typename Output>
+    void process(const SampleType* left, const SampleType* right, int numSamples, Output& fifo)
+    {
+        updateFactor(fifo);
+
+        if (factor == 1)
+        {
+            fifo.push(left, right, numSamples);
+            return;
+        }
+
+        int numPoints = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float l = static_cast<float>(left[i]);
+            const float r = static_cast<float>(right[i]);
+            const float energy = l * l + r * r;
+
+            if (energy > bestEnergy)
+            {
+                bestEnergy = energy;
+                bestLeft = l;
+                bestRight = r;
+            }
+
+            if (++groupCount == factor)
+            {
+                pointsLeft[(size_t) numPoints] = bestLeft;
+                pointsRight[(size_t) numPoints] = bestRight;
+                groupCount = 0;
+                bestEnergy = -1.0f;
+
+                if (++numPoints == batchSize)
+                {
+                    fifo.push(pointsLeft.data(), pointsRight.data(), numPoints);
+                    numPoints = 0;
+                }
+            }
+        }
+
+        fifo.push(pointsLeft.data(), pointsRight.data(), numPoints);
+    }
+
+private:
+    template <typename Output>
+    void updateFactor(Output& fifo)
+    {
+        float window = windowMs.load();
+        int budget = pointBudget.load();
+
+        if (window == appliedWindowMs && budget == appliedBudget)
+            return;
+
+        appliedWindowMs = window;
+        appliedBudget = budget;
+
+        double windowSamples = sampleRate * window * 0.001;
+        factor = juce::jmax(1, static_cast<int>(std::ceil(windowSamples / budget)));
+        groupCount = 0;
+        bestEnergy = -1.0f;
+
+        fifo.setPointsPerWindow(juce::jlimit(1, budget, static_cast<int>(std::ceil(windowSamples / factor))));
+    }
+
+    static constexpr int batchSize = 256;
+
+    std::atomic<float> windowMs { 23.0f }; // ~1024 samples at 44.1 kHz, the scope's original span
+    std::atomic<int> pointBudget { 1024 };
+
+    double sampleRate = 44100.0;
+    float appliedWindowMs = -1.0f;
+    int appliedBudget = 0;
+    int factor = 1;
+
+    // Group carried across blocks so the result doesn't depend on block size
+    int groupCount = 0;
+    float bestEnergy = -1.0f, bestLeft = 0.0f, bestRight = 0.0f;
+
+    std::array<float, batchSize> pointsLeft {}, pointsRight {};
+};
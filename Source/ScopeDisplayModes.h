@@ -0,0 +1,134 @@
+/*
+  ==============================================================================
+
+    ScopeDisplayModes.h
+    Created: 17 Oct 2026 1:21:41pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// How the vectorscope maps a (left, right) pair onto the screen.
+//
+//   lissajous    mid up, side across: the classic 45-degree goniometer
+//   polarSample  the same, folded into the upper half so that out-of-phase
+//                energy lies along the horizontal axis
+//   polarLevel   polarSample's angle with a 60 dB level scale as the radius,
+//                drawn as rays from the origin
+//   rawXY        left across, right up, no rotation
+//
+// The transforms work on whole batches so they compile to vector loops, and
+// each mode is a template argument so a frame is drawn without testing the
+// mode per point.
+enum class ScopeMode { lissajous, polarSample, polarLevel, rawXY };
+constexpr int numScopeModes = 4;
+
+inline const char* getScopeModeName(ScopeMode mode)
+{
+    switch (mode)
+    {
+        case ScopeMode::lissajous:   return "Lissajous";
+        case ScopeMode::polarSample: return "Polar Sample";
+        case ScopeMode::polarLevel:  return "Polar Level";
+        case ScopeMode::rawXY:       return "Raw X/Y";
+    }
+
+    return "";
+}
+
+// Calls function with the mode as a compile-time constant
+template <typename Function>
+void withScopeMode(ScopeMode mode, Function&& function)
+{
+    switch (mode)
+    {
+        case ScopeMode::lissajous:   function(std::integral_constant<ScopeMode, ScopeMode::lissajous>()); break;
+        case ScopeMode::polarSample: function(std::integral_constant<ScopeMode, ScopeMode::polarSample>()); break;
+        case ScopeMode::polarLevel:  function(std::integral_constant<ScopeMode, ScopeMode::polarLevel>()); break;
+        case ScopeMode::rawXY:       function(std::integral_constant<ScopeMode, ScopeMode::rawXY>()); break;
+    }
+}
+
+template <ScopeMode mode>
+constexpr bool isPolar = mode == ScopeMode::polarSample || mode == ScopeMode::polarLevel;
+
+// Where a mode's origin sits in a frame, and how many pixels one unit is
+struct ScopeGeometry
+{
+    float originX = 0.0f, originY = 0.0f, scale = 1.0f;
+
+    template <ScopeMode mode>
+    static ScopeGeometry forFrame(int width, int height)
+    {
+        if constexpr (isPolar<mode>)
+        {
+            // Half disc standing on a line near the bottom edge
+            const float radius = juce::jmin(width * 0.5f, height * 0.9f) * 0.95f;
+            return { width * 0.5f, height * 0.9f, mode == ScopeMode::polarLevel ? radius : radius * 0.7071f };
+        }
+        else
+        {
+            return { width * 0.5f, height * 0.5f, juce::jmin(width, height) * 0.45f };
+        }
+    }
+
+    // In place, y pointing down as on screen
+    void toPixels(float* x, float* y, int numPoints) const
+    {
+        juce::FloatVectorOperations::multiply(x, scale, numPoints);
+        juce::FloatVectorOperations::add(x, originX, numPoints);
+        juce::FloatVectorOperations::multiply(y, -scale, numPoints);
+        juce::FloatVectorOperations::add(y, originY, numPoints);
+    }
+};
+
+// Maps numPoints pairs to x (positive to the right) and y (positive up).
+// A full-scale left-only or right-only signal lands at a distance of about 1.
+template <ScopeMode mode>
+void transformScopePoints(const float* left, const float* right, float* x, float* y, int numPoints)
+{
+    if constexpr (mode == ScopeMode::rawXY)
+    {
+        juce::FloatVectorOperations::copy(x, left, numPoints);
+        juce::FloatVectorOperations::copy(y, right, numPoints);
+    }
+    else
+    {
+        // Side across, mid up; a left-only signal leans to the left
+        constexpr float k = 0.70710678f;
+        juce::FloatVectorOperations::subtract(x, right, left, numPoints);
+        juce::FloatVectorOperations::multiply(x, k, numPoints);
+        juce::FloatVectorOperations::add(y, left, right, numPoints);
+        juce::FloatVectorOperations::multiply(y, k, numPoints);
+
+        if constexpr (isPolar<mode>)
+        {
+            // Point-reflect the lower half: same angle from the mid axis, same
+            // level, so polarity no longer matters, only the stereo position
+            for (int i = 0; i < numPoints; ++i)
+            {
+                const float sign = y[i] < 0.0f ? -1.0f : 1.0f;
+                x[i] *= sign;
+                y[i] *= sign;
+            }
+        }
+
+        if constexpr (mode == ScopeMode::polarLevel)
+        {
+            // Radius from -60 dBFS (origin) to 0 dBFS (1), direction kept
+            constexpr float floorDb = -60.0f;
+
+            for (int i = 0; i < numPoints; ++i)
+            {
+                const float squared = x[i] * x[i] + y[i] * y[i];
+                const float level = juce::jlimit(0.0f, 1.0f, 1.0f - 10.0f * std::log10(squared + 1.0e-12f) / floorDb);
+                const float scale = squared > 1.0e-12f ? level / std::sqrt(squared) : 0.0f;
+                x[i] *= scale;
+                y[i] *= scale;
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    ScopeFifo.h
+    Created: 17 Oct 2026 12:50:06pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Wait-free single-producer/single-consumer ring for handing stereo samples
+// from the audio thread to the UI. The processor pushes every block, the
+// vectorscope drains whatever has arrived once per display frame.
+class ScopeFifo
+{
+public:
+    static constexpr int capacity = 16384; // ~85 ms at 192 kHz
+    static constexpr int maxPointsPerWindow = 4096;
+
+    ScopeFifo()
+    {
+        buffer.setSize(2, capacity);
+        buffer.clear();
+    }
+
+    // Audio thread only. If the UI has stopped draining (editor closed) the
+    // samples that don't fit are dropped instead of blocking. Double input is
+    // narrowed as it is written; the display doesn't need more.
+    template <typename SampleType>
+    void push(const SampleType* leftSamples, const SampleType* rightSamples, int numSamples)
+    {
+        const auto scope = fifo.write(juce::jmin(numSamples, fifo.getFreeSpace()));
+
+        if (scope.blockSize1 > 0)
+        {
+            write(0, scope.startIndex1, leftSamples, scope.blockSize1);
+            write(1, scope.startIndex1, rightSamples, scope.blockSize1);
+        }
+
+        if (scope.blockSize2 > 0)
+        {
+            write(0, scope.startIndex2, leftSamples + scope.blockSize1, scope.blockSize2);
+            write(1, scope.startIndex2, rightSamples + scope.blockSize1, scope.blockSize2);
+        }
+    }
+
+    // Consumer thread only. Copies up to maxSamples of the oldest unread
+    // samples and returns how many were copied.
+    int pull(float* leftSamples, float* rightSamples, int maxSamples)
+    {
+        const auto scope = fifo.read(juce::jmin(maxSamples, fifo.getNumReady()));
+
+        if (scope.blockSize1 > 0)
+        {
+            juce::FloatVectorOperations::copy(leftSamples, buffer.getReadPointer(0, scope.startIndex1), scope.blockSize1);
+            juce::FloatVectorOperations::copy(rightSamples, buffer.getReadPointer(1, scope.startIndex1), scope.blockSize1);
+        }
+
+        if (scope.blockSize2 > 0)
+        {
+            juce::FloatVectorOperations::copy(leftSamples + scope.blockSize1, buffer.getReadPointer(0, scope.startIndex2), scope.blockSize2);
+            juce::FloatVectorOperations::copy(rightSamples + scope.blockSize1, buffer.getReadPointer(1, scope.startIndex2), scope.blockSize2);
+        }
+
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    // Consumer thread only. Throws away samples the display would overwrite anyway.
+    void discard(int numSamples)
+    {
+        fifo.read(juce::jmin(numSamples, fifo.getNumReady()));
+    }
+
+    int getNumReady() const { return fifo.getNumReady(); }
+    
+    // How many of the most recent points make up one display window. Set by
+    // the producer whenever its decimation changes.
+    void setPointsPerWindow(int numPoints) { pointsPerWindow.store(numPoints); }
+    int getPointsPerWindow() const         { return pointsPerWindow.load(); }
+
+private:
+    template <typename SampleType>
+    void write(int channel, int startIndex, const SampleType* source, int numSamples)
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            buffer.copyFrom(channel, startIndex, source, numSamples);
+        }
+        else
+        {
+            float* destination = buffer.getWritePointer(channel, startIndex);
+            for (int i = 0; i < numSamples; ++i)
+                destination[i] = static_cast<float>(source[i]);
+        }
+    }
+
+    juce::AbstractFifo fifo { capacity };
+    juce::AudioBuffer<float> buffer;
+    std::atomic<int> pointsPerWindow { 1024 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScopeFifo)
+};
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    SharedMemoryExport.cpp
+    Created: 17 Oct 2026 1:18:40pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#include "SharedMemoryExport.h"
+
+bool SharedMemoryExport::setEnabled(bool shouldBeEnabled)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (shouldBeEnabled == isEnabled())
+        return true;
+
+    if (! shouldBeEnabled)
+    {
+        // Once the audio thread is out of its current block it can no longer
+        // see the mapping; that's a single block at most, so spinning is fine
+        layout.store(nullptr);
+        while (writing.load())
+            juce::Thread::yield();
+
+        file.reset();
+        path.deleteFile();
+        path = juce::File();
+        return true;
+    }
+
+    auto directory = juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("VectorScopeExport");
+    if (! directory.createDirectory())
+        return false;
+
+    auto newPath = directory.getNonexistentChildFile("instance", ".vshm", false);
+
+    // The mapping can't grow the file, so it is written out at full size first
+    {
+        juce::FileOutputStream stream(newPath);
+        if (! stream.openedOk() || ! stream.writeRepeatedByte(0, sizeof(Layout)))
+            return false;
+    }
+
+    auto newFile = std::make_unique<juce::MemoryMappedFile>(newPath, juce::MemoryMappedFile::readWrite);
+    if (newFile->getData() == nullptr || newFile->getSize() < sizeof(Layout))
+    {
+        newFile.reset();
+        newPath.deleteFile();
+        return false;
+    }
+
+    auto* newLayout = new (newFile->getData()) Layout();
+    newLayout->header.magic = magic;
+    newLayout->header.version = version;
+    newLayout->header.pointsOffset = static_cast<juce::uint32>(offsetof(Layout, points));
+    newLayout->header.pointCapacity = pointCapacity;
+    writeName(*newLayout);
+
+    file = std::move(newFile);
+    path = newPath;
+    layout.store(newLayout);
+    return true;
+}
+
+void SharedMemoryExport::setName(const juce::String& newName)
+{
+    const juce::ScopedLock sl(lock);
+    name = newName;
+
+    if (auto* current = layout.load())
+        writeName(*current);
+}
+
+void SharedMemoryExport::writeName(Layout& target)
+{
+    auto& block = target.nameBlock;
+    const auto sequence = block.sequence.load(std::memory_order_relaxed);
+
+    block.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Truncated on a character boundary if it doesn't fit
+    std::fill(std::begin(block.name), std::end(block.name), '\0');
+    name.copyToUTF8(block.name, sizeof(block.name));
+
+    block.sequence.store(sequence + 2, std::memory_order_release);
+}
@@ -0,0 +1,207 @@
+/*
+  ==============================================================================
+
+    SharedMemoryExport.h
+    Created: 17 Oct 2026 1:18:40pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "CorrelationMeter.h"
+
+// Publishes the decimated scope points and the meter readings into a
+// memory-mapped file, for a monitoring application on the same machine that
+// watches many instances at once. The reader maps the file and reads it in
+// place: no syscalls, no copies, no locks on either side.
+//
+// Files live in <temp>/VectorScopeExport/, one per enabled instance, and are
+// deleted when the export is switched off. All values are native-endian.
+//
+//   offset  size  field
+//   ------  ----  -----------------------------------------------------------
+//        0     4  magic, 'VSHM' (0x4d485356)
+//        4     4  version, 2
+//        8     4  pointsOffset, byte offset of the point ring (256)
+//       12     4  pointCapacity, points in the ring, a power of two
+//       16     8  pointsClaimed    } running point counts, see below
+//       24     8  pointsPublished  }
+//       64     4  sequence, even when the meters are stable, odd while written
+//       68     4  pointsPerWindow, how many recent points make up one scope frame
+//       72     8  blockCounter, processBlock calls since the export started
+//       80     8  sampleRate (double)
+//       88    36  correlation slow, fast, integrated; loudness momentary,
+//                 short-term, integrated (LUFS); true-peak L, R (dBTP);
+//                 mid/side ratio (dB) -- nine floats
+//      128     4  nameSequence, as sequence but for the name
+//      132   124  name, the host's name for this instance's track, UTF-8,
+//                 zero-padded; empty if the host doesn't pass one
+//      256   8 N  point ring: N = pointCapacity (L, R) float pairs. Point k
+//                 (counting from the start of the export) is at k % N.
+//
+// Meters are a seqlock: read sequence, give up if it is odd, read the fields,
+// then re-read sequence and retry if it changed. The name works the same way
+// with nameSequence; it only changes when the host renames the track.
+//
+// Points: read pointsPublished (acquire) as `end`; points up to `end` are
+// complete. Read what you need of the last N of them, then re-read
+// pointsClaimed (after an acquire fence): anything older than
+// pointsClaimed - N may have been overwritten while you were reading.
+class SharedMemoryExport
+{
+public:
+    static constexpr juce::uint32 magic = 0x4d485356;
+    static constexpr juce::uint32 version = 2;
+    static constexpr int pointCapacity = 16384;
+
+    // The values that go into the meter block, in layout order
+    struct Meters
+    {
+        float correlation = 0.0f, correlationFast = 0.0f, correlationIntegrated = 0.0f;
+        float momentaryLoudness = CorrelationMeter::minimumLevel;
+        float shortTermLoudness = CorrelationMeter::minimumLevel;
+        float integratedLoudness = CorrelationMeter::minimumLevel;
+        float truePeakLeft = CorrelationMeter::minimumLevel, truePeakRight = CorrelationMeter::minimumLevel;
+        float midSideRatio = 0.0f;
+    };
+
+    SharedMemoryExport() = default;
+    ~SharedMemoryExport() { setEnabled(false); }
+
+    //==========================================================================
+    // Message thread
+
+    // Creates and maps the file, or unmaps and deletes it. Returns false if
+    // the file couldn't be created; the export stays off then.
+    bool setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const { return file != nullptr; }
+
+    juce::File getFile() const { return path; }
+
+    // Any thread but the audio thread. Kept while the export is off and
+    // written into the file whenever it is on.
+    void setName(const juce::String& newName);
+
+    //==========================================================================
+    // Audio thread. Wait-free and allocation-free; does nothing while the
+    // export is off.
+
+    void prepare(double newSampleRate) { sampleRate = newSampleRate; }
+
+    // Brackets everything written during one block
+    void beginBlock()
+    {
+        writing.store(true);
+        active = layout.load();
+    }
+
+    void endBlock(const Meters& meters)
+    {
+        if (active != nullptr)
+        {
+            auto& block = active->meterBlock;
+            const auto sequence = block.sequence.load(std::memory_order_relaxed);
+
+            block.sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            block.pointsPerWindow = static_cast<juce::uint32>(pointsPerWindow);
+            block.blockCounter = block.blockCounter + 1;
+            block.sampleRate = sampleRate;
+            block.meters = meters;
+
+            block.sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        active = nullptr;
+        writing.store(false);
+    }
+
+    // Same interface as ScopeFifo, so the decimator can feed both
+    template <typename SampleType>
+    void push(const SampleType* leftSamples, const SampleType* rightSamples, int numSamples)
+    {
+        if (active == nullptr || numSamples <= 0)
+            return;
+
+        // Only the newest pointCapacity points of a huge block can survive anyway
+        const int skipped = juce::jmax(0, numSamples - pointCapacity);
+        leftSamples += skipped;
+        rightSamples += skipped;
+        numSamples -= skipped;
+
+        auto& header = active->header;
+        const auto start = header.pointsPublished.load(std::memory_order_relaxed) + (juce::uint64) skipped;
+
+        header.pointsClaimed.store(start + (juce::uint64) numSamples, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* point = active->points[(start + (juce::uint64) i) & (pointCapacity - 1)];
+            point[0] = static_cast<float>(leftSamples[i]);
+            point[1] = static_cast<float>(rightSamples[i]);
+        }
+
+        header.pointsPublished.store(start + (juce::uint64) numSamples, std::memory_order_release);
+    }
+
+    void setPointsPerWindow(int numPoints) { pointsPerWindow = numPoints; }
+
+private:
+    struct alignas(64) Header
+    {
+        juce::uint32 magic, version, pointsOffset, pointCapacity;
+        std::atomic<juce::uint64> pointsClaimed, pointsPublished;
+    };
+
+    struct alignas(64) MeterBlock
+    {
+        std::atomic<juce::uint32> sequence;
+        juce::uint32 pointsPerWindow;
+        juce::uint64 blockCounter;
+        double sampleRate;
+        Meters meters;
+    };
+
+    struct alignas(64) NameBlock
+    {
+        std::atomic<juce::uint32> sequence;
+        char name[124];
+    };
+
+    struct Layout
+    {
+        Header header;
+        MeterBlock meterBlock;
+        NameBlock nameBlock;
+        float points[pointCapacity][2];
+    };
+
+    static_assert(std::atomic<juce::uint64>::is_always_lock_free && std::atomic<juce::uint32>::is_always_lock_free,
+                  "the counters must be lock-free to work across processes");
+    static_assert(sizeof(Header) == 64 && sizeof(MeterBlock) == 64 && sizeof(Meters) == 36 && sizeof(NameBlock) == 128,
+                  "the layout is documented above; bump the version if it changes");
+    static_assert((pointCapacity & (pointCapacity - 1)) == 0);
+
+    // Under lock, which setEnabled() and setName() take
+    void writeName(Layout& target);
+
+    // Owned by the message thread; the audio thread only sees layout
+    juce::CriticalSection lock;
+    std::unique_ptr<juce::MemoryMappedFile> file;
+    juce::File path;
+    juce::String name;
+
+    std::atomic<Layout*> layout { nullptr };
+    std::atomic<bool> writing { false };
+
+    // Audio thread
+    Layout* active = nullptr;
+    double sampleRate = 44100.0;
+    int pointsPerWindow = 1024;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharedMemoryExport)
+};
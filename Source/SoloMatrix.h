@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    SoloMatrix.h
+    Created: 17 Oct 2026 12:51:02pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// The three solo buttons packed into a bit mask so the combination can be
+// resolved once per block and each of the 8 cases gets its own kernel.
+// Kernels are templated on the sample type for the float and double paths.
+namespace SoloMatrix
+{
+    enum Mode : int
+    {
+        none   = 0,
+        left   = 1 << 0,
+        center = 1 << 1,
+        right  = 1 << 2
+    };
+
+    inline int getMode(bool soloLeft, bool soloCenter, bool soloRight)
+    {
+        return (soloLeft ? left : 0) | (soloCenter ? center : 0) | (soloRight ? right : 0);
+    }
+
+    // Center only applies when neither side is soloed, so L+C behaves like L,
+    // R+C like R and L+C+R like L+R (both sides untouched).
+    template <int mode, typename SampleType>
+    inline void processStereo(SampleType* leftChannel, SampleType* rightChannel, int numSamples)
+    {
+        constexpr bool soloLeft = (mode & left) != 0;
+        constexpr bool soloCenter = (mode & center) != 0;
+        constexpr bool soloRight = (mode & right) != 0;
+
+        if constexpr (soloLeft && ! soloRight)
+        {
+            juce::FloatVectorOperations::clear(rightChannel, numSamples);
+        }
+        else if constexpr (soloRight && ! soloLeft)
+        {
+            juce::FloatVectorOperations::clear(leftChannel, numSamples);
+        }
+        else if constexpr (soloCenter && ! soloLeft && ! soloRight)
+        {
+            juce::FloatVectorOperations::add(leftChannel, rightChannel, numSamples);
+            juce::FloatVectorOperations::multiply(leftChannel, static_cast<SampleType>(0.5), numSamples);
+            juce::FloatVectorOperations::copy(rightChannel, leftChannel, numSamples);
+        }
+    }
+
+    // With a single channel L, C and L+R all leave the signal as it is; only
+    // soloing the (non-existent) right side without the left one silences it.
+    template <int mode, typename SampleType>
+    inline void processMono(SampleType* channel, int numSamples)
+    {
+        if constexpr ((mode & right) != 0 && (mode & left) == 0)
+            juce::FloatVectorOperations::clear(channel, numSamples);
+    }
+
+    template <int mode, typename SampleType>
+    inline void process(SampleType* leftChannel, SampleType* rightChannel, int numSamples)
+    {
+        if (leftChannel == rightChannel)
+            processMono<mode>(leftChannel, numSamples);
+        else
+            processStereo<mode>(leftChannel, rightChannel, numSamples);
+    }
+
+    // Picks the kernel for this block. rightChannel may alias leftChannel for mono.
+    template <typename SampleType>
+    inline void process(int mode, SampleType* leftChannel, SampleType* rightChannel, int numSamples)
+    {
+        switch (mode)
+        {
+            case left:                   process<left>(leftChannel, rightChannel, numSamples); break;
+            case center:                 process<center>(leftChannel, rightChannel, numSamples); break;
+            case right:                  process<right>(leftChannel, rightChannel, numSamples); break;
+            case left | center:          process<left | center>(leftChannel, rightChannel, numSamples); break;
+            case left | right:           process<left | right>(leftChannel, rightChannel, numSamples); break;
+            case center | right:         process<center | right>(leftChannel, rightChannel, numSamples); break;
+            case left | center | right:  process<left | center | right>(leftChannel, rightChannel, numSamples); break;
+            default:                     break; // nothing soloed, pass through
+        }
+    }
+}
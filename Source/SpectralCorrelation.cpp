@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+    SpectralCorrelation.cpp
+    Created: 17 Oct 2026 1:04:58pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#include "SpectralCorrelation.h"
+
+SpectralCorrelation::SpectralCorrelation()
+: juce::Thread("Spectral Correlation")
+{
+}
+
+SpectralCorrelation::~SpectralCorrelation()
+{
+    stopThread(1000);
+}
+
+void SpectralCorrelation::prepare(double sampleRate, float integrationTimeMs)
+{
+    const juce::ScopedLock sl(lifecycleLock);
+    stopThread(1000);
+
+    if (fft == nullptr)
+    {
+        fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+
+        window.resize((size_t) fftSize);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t) fftSize,
+                                                                 juce::dsp::WindowingFunction<float>::hann, false);
+
+        for (auto* v : { &historyLeft, &historyRight })
+            v->assign((size_t) fftSize, 0.0f);
+
+        // The real-only transform works in place on 2 * fftSize floats
+        for (auto* v : { &fftLeft, &fftRight })
+            v->assign((size_t) (2 * fftSize), 0.0f);
+
+        for (auto* v : { &powerLeft, &powerRight, &crossReal, &crossImag })
+            v->assign((size_t) numBins, 0.0f);
+    }
+
+    decay = static_cast<float>(std::exp(-hopSize / (sampleRate * juce::jmax(1.0e-3, integrationTimeMs * 0.001))));
+
+    // Band edges a sixth of an octave either side of the centre. The lowest
+    // bands are narrower than a bin at high sample rates, so each gets at
+    // least the bin its centre falls in.
+    const double binsPerHz = fftSize / sampleRate;
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        const double centre = getBandFrequency(band);
+        int start = juce::jlimit(1, numBins - 1, static_cast<int>(std::ceil(centre * std::exp2(-1.0 / 6.0) * binsPerHz)));
+        int end = juce::jlimit(1, numBins, static_cast<int>(std::ceil(centre * std::exp2(1.0 / 6.0) * binsPerHz)));
+
+        if (end <= start)
+        {
+            start = juce::jlimit(1, numBins - 1, juce::roundToInt(centre * binsPerHz));
+            end = start + 1;
+        }
+
+        bandStart[(size_t) band] = start;
+        bandEnd[(size_t) band] = end;
+    }
+
+    prepared = true;
+
+    if (enabled.load())
+        startWorker();
+}
+
+void SpectralCorrelation::release()
+{
+    const juce::ScopedLock sl(lifecycleLock);
+    stopThread(1000);
+    prepared = false;
+}
+
+void SpectralCorrelation::setEnabled(bool shouldBeEnabled)
+{
+    const juce::ScopedLock sl(lifecycleLock);
+
+    if (shouldBeEnabled == enabled.load())
+        return;
+
+    enabled.store(shouldBeEnabled);
+
+    if (! shouldBeEnabled)
+        stopThread(1000);
+    else if (prepared)
+        startWorker();
+}
+
+void SpectralCorrelation::startWorker()
+{
+    // Nothing else reads the FIFO while the worker is stopped
+    fifo.discard(fifo.getNumReady());
+    clearSpectra();
+    startThread(juce::Thread::Priority::low);
+}
+
+void SpectralCorrelation::run()
+{
+    while (! threadShouldExit())
+    {
+        // The audio thread never signals; at 10 ms the FIFO holds at most ~2k samples at 192 kHz
+        wait(10);
+
+        bool analysed = false;
+
+        while (fifo.getNumReady() >= hopSize && ! threadShouldExit())
+        {
+            // Slide the analysis window along by one hop
+            std::copy(historyLeft.begin() + hopSize, historyLeft.end(), historyLeft.begin());
+            std::copy(historyRight.begin() + hopSize, historyRight.end(), historyRight.begin());
+            fifo.pull(historyLeft.data() + fftSize - hopSize, historyRight.data() + fftSize - hopSize, hopSize);
+
+            analyseFrame();
+            analysed = true;
+        }
+
+        if (analysed)
+            publish();
+    }
+}
+
+void SpectralCorrelation::analyseFrame()
+{
+    juce::FloatVectorOperations::multiply(fftLeft.data(), historyLeft.data(), window.data(), fftSize);
+    juce::FloatVectorOperations::multiply(fftRight.data(), historyRight.data(), window.data(), fftSize);
+
+    fft->performRealOnlyForwardTransform(fftLeft.data(), true);
+    fft->performRealOnlyForwardTransform(fftRight.data(), true);
+
+    // Bin k of each spectrum is (re, im) at [2k, 2k + 1]. L * conj(R) gives
+    // the cross-spectrum; its angle is how far R lags L in that bin.
+    const float* l = fftLeft.data();
+    const float* r = fftRight.data();
+    const float a = decay, b = 1.0f - decay;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const float lr = l[2 * k], li = l[2 * k + 1];
+        const float rr = r[2 * k], ri = r[2 * k + 1];
+
+        powerLeft[(size_t) k]  = a * powerLeft[(size_t) k]  + b * (lr * lr + li * li);
+        powerRight[(size_t) k] = a * powerRight[(size_t) k] + b * (rr * rr + ri * ri);
+        crossReal[(size_t) k]  = a * crossReal[(size_t) k]  + b * (lr * rr + li * ri);
+        crossImag[(size_t) k]  = a * crossImag[(size_t) k]  + b * (li * rr - lr * ri);
+    }
+}
+
+void SpectralCorrelation::publish()
+{
+    for (int band = 0; band < numBands; ++band)
+    {
+        double ll = 0.0, rr = 0.0, re = 0.0, im = 0.0;
+
+        for (int k = bandStart[(size_t) band]; k < bandEnd[(size_t) band]; ++k)
+        {
+            ll += powerLeft[(size_t) k];
+            rr += powerRight[(size_t) k];
+            re += crossReal[(size_t) k];
+            im += crossImag[(size_t) k];
+        }
+
+        const double denom = std::sqrt(ll * rr);
+        const float correlation = denom > 0.0 ? static_cast<float>(juce::jlimit(-1.0, 1.0, re / denom)) : 0.0f;
+        const float phase = denom > 0.0 ? static_cast<float>(std::atan2(im, re)) : 0.0f;
+
+        correlations[(size_t) band].store(correlation, std::memory_order_relaxed);
+        phases[(size_t) band].store(phase, std::memory_order_relaxed);
+    }
+}
+
+void SpectralCorrelation::clearSpectra()
+{
+    for (auto* v : { &historyLeft, &historyRight, &powerLeft, &powerRight, &crossReal, &crossImag })
+        std::fill(v->begin(), v->end(), 0.0f);
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        correlations[(size_t) band].store(0.0f, std::memory_order_relaxed);
+        phases[(size_t) band].store(0.0f, std::memory_order_relaxed);
+    }
+}
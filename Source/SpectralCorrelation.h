@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    SpectralCorrelation.h
+    Created: 17 Oct 2026 1:04:58pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "ScopeFifo.h"
+
+// Correlation and phase per third-octave band. The audio thread only pushes
+// samples into a FIFO; a worker thread runs Hann-windowed real FFTs with 75 %
+// overlap, integrates the auto- and cross-spectra of the pair bin by bin and
+// publishes one correlation and one phase value per band. The worker only
+// exists while the display is on and the processor is prepared.
+class SpectralCorrelation : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 4;
+    static constexpr int numBins = fftSize / 2 + 1;
+    static constexpr int numBands = 31; // 20 Hz to 20 kHz in thirds of an octave
+
+    SpectralCorrelation();
+    ~SpectralCorrelation() override;
+
+    // Allocates everything the worker needs, and restarts it if the display
+    // is on. Call from prepareToPlay; release() stops the worker.
+    void prepare(double sampleRate, float integrationTimeMs = 300.0f);
+    void release();
+
+    // Audio thread. Does nothing while the display is off.
+    template <typename SampleType>
+    void push(const SampleType* left, const SampleType* right, int numSamples)
+    {
+        if (enabled.load(std::memory_order_relaxed))
+            fifo.push(left, right, numSamples);
+    }
+
+    // Message thread. Turning the display on starts the worker (once
+    // prepared) with cleared spectra; turning it off stops it.
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const { return enabled.load(); }
+
+    // Any thread
+    float getCorrelation(int band) const  { return correlations[(size_t) band].load(std::memory_order_relaxed); }
+    float getPhase(int band) const        { return phases[(size_t) band].load(std::memory_order_relaxed); } // radians, R relative to L
+    static float getBandFrequency(int band) { return 20.0f * std::exp2(band / 3.0f); }
+
+private:
+    void run() override;
+
+    // Worker thread only
+    void analyseFrame();
+    void publish();
+    void clearSpectra();
+
+    // Under lifecycleLock, with the worker stopped
+    void startWorker();
+
+    ScopeFifo fifo;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> window, historyLeft, historyRight, fftLeft, fftRight;
+
+    // Integrated spectra, one entry per bin, kept as separate arrays so the
+    // per-bin update is a straight vectorisable loop
+    std::vector<float> powerLeft, powerRight, crossReal, crossImag;
+    float decay = 0.0f;
+
+    std::array<int, numBands> bandStart {}, bandEnd {}; // Bin range [start, end) of each band
+
+    // prepare()/release() may come from another thread than setEnabled()
+    juce::CriticalSection lifecycleLock;
+    bool prepared = false;
+
+    std::atomic<bool> enabled { false };
+    std::array<std::atomic<float>, numBands> correlations {}, phases {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectralCorrelation)
+};
@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+    StereoMatrix.h
+    Created: 17 Oct 2026 12:51:54pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "TempoSyncedLfo.h"
+
+// Rotation and width folded into a single 2x2 matrix on L/R:
+//
+//     [L']   [cos -sin]   [(1+w)/2  (1-w)/2]   [L]
+//     [R'] = [sin  cos] * [(1-w)/2  (1+w)/2] * [R]
+//
+// Width scales the side signal (w = 0 mono, 1 unchanged, 2 double), rotation
+// turns the image on the goniometer. Both are smoothed, and the coefficients
+// are ramped linearly across each block so the whole thing is one pass.
+//
+// With tempo sync on, the rotation becomes the depth of a tempo-synced sine:
+// the angle is worked out per sample from the LFO and table sin/cos inside
+// the same pass. Sync is faded in and out over the smoothing time.
+class StereoMatrix
+{
+public:
+    void prepare(double sampleRate)
+    {
+        rotation.reset(sampleRate, smoothingSeconds);
+        width.reset(sampleRate, smoothingSeconds);
+        modulation.reset(sampleRate, smoothingSeconds);
+        snapToTarget();
+    }
+
+    // Drops any smoothing in progress, e.g. while the output is muted
+    void snapToTarget()
+    {
+        rotation.setCurrentAndTargetValue(rotation.getTargetValue());
+        width.setCurrentAndTargetValue(width.getTargetValue());
+        modulation.setCurrentAndTargetValue(modulation.getTargetValue());
+        currentAngle = rotation.getTargetValue();
+        currentWidth = width.getTargetValue();
+        currentModulation = modulation.getTargetValue();
+        current = computeCoefficients(currentAngle, currentWidth);
+    }
+
+    void setParameters(float rotationDegrees, float widthPercent, bool tempoSync = false)
+    {
+        rotation.setTargetValue(juce::degreesToRadians(rotationDegrees));
+        width.setTargetValue(widthPercent * 0.01f);
+        modulation.setTargetValue(tempoSync ? 1.0f : 0.0f);
+    }
+
+    // lfo has been synced for this block; it is advanced by numSamples either way.
+    // Coefficients are float, the samples are processed at their own precision.
+    template <typename SampleType>
+    void process(SampleType* leftChannel, SampleType* rightChannel, int numSamples, TempoSyncedLfo& lfo)
+    {
+        if (numSamples <= 0)
+            return;
+
+        rotation.skip(numSamples);
+        width.skip(numSamples);
+        modulation.skip(numSamples);
+
+        const float newAngle = rotation.getCurrentValue();
+        const float newWidth = width.getCurrentValue();
+        const float newModulation = modulation.getCurrentValue();
+
+        if (newModulation > 0.0f || currentModulation > 0.0f)
+        {
+            applyModulated(leftChannel, rightChannel, numSamples, lfo, newAngle, newWidth, newModulation);
+            return;
+        }
+
+        lfo.skip(numSamples);
+
+        if (newAngle == currentAngle && newWidth == currentWidth)
+        {
+            // Settled at the identity (0 degrees, 100 %): nothing to do
+            if (current.isIdentity())
+                return;
+
+            applyConstant(leftChannel, rightChannel, numSamples);
+            return;
+        }
+
+        const auto target = computeCoefficients(newAngle, newWidth);
+        applyRamp(leftChannel, rightChannel, numSamples, target);
+
+        current = target;
+        currentAngle = newAngle;
+        currentWidth = newWidth;
+    }
+
+private:
+    struct Coefficients
+    {
+        float ll = 1.0f, lr = 0.0f, rl = 0.0f, rr = 1.0f;
+
+        bool isIdentity() const
+        {
+            return ll == 1.0f && lr == 0.0f && rl == 0.0f && rr == 1.0f;
+        }
+    };
+
+    static Coefficients computeCoefficients(float angle, float w)
+    {
+        // Snap the defaults to an exact identity so the bypass check above holds
+        if (angle == 0.0f && w == 1.0f)
+            return {};
+
+        const float c = std::cos(angle);
+        const float s = std::sin(angle);
+        const float direct = (1.0f + w) * 0.5f;
+        const float cross = (1.0f - w) * 0.5f;
+
+        return { c * direct - s * cross,
+                 c * cross - s * direct,
+                 s * direct + c * cross,
+                 s * cross + c * direct };
+    }
+
+    template <typename SampleType>
+    void applyConstant(SampleType* leftChannel, SampleType* rightChannel, int numSamples) const
+    {
+        const auto m = current;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const SampleType l = leftChannel[i];
+            const SampleType r = rightChannel[i];
+            leftChannel[i] = m.ll * l + m.lr * r;
+            rightChannel[i] = m.rl * l + m.rr * r;
+        }
+    }
+
+    // Coefficients are derived from the sample index rather than accumulated,
+    // which keeps the loop free of carried dependencies so it vectorises.
+    template <typename SampleType>
+    void applyRamp(SampleType* leftChannel, SampleType* rightChannel, int numSamples, const Coefficients& target) const
+    {
+        const auto m = current;
+        const float step = 1.0f / static_cast<float>(numSamples);
+        const float dll = (target.ll - m.ll) * step;
+        const float dlr = (target.lr - m.lr) * step;
+        const float drl = (target.rl - m.rl) * step;
+        const float drr = (target.rr - m.rr) * step;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float t = static_cast<float>(i + 1);
+            const SampleType l = leftChannel[i];
+            const SampleType r = rightChannel[i];
+            leftChannel[i] = (m.ll + dll * t) * l + (m.lr + dlr * t) * r;
+            rightChannel[i] = (m.rl + drl * t) * l + (m.rr + drr * t) * r;
+        }
+    }
+
+    // The angle is depth * (1 - m + m * lfo): the static rotation at m = 0,
+    // the full LFO swing at m = 1. Depth, width and m are all ramped.
+    template <typename SampleType>
+    void applyModulated(SampleType* leftChannel, SampleType* rightChannel, int numSamples, TempoSyncedLfo& lfo,
+                        float newAngle, float newWidth, float newModulation)
+    {
+        constexpr int chunkSize = 64;
+        float lfoValues[chunkSize];
+
+        const float step = 1.0f / static_cast<float>(numSamples);
+        const float dAngle = (newAngle - currentAngle) * step;
+        const float dWidth = (newWidth - currentWidth) * step;
+        const float dModulation = (newModulation - currentModulation) * step;
+        float angle = currentAngle;
+
+        for (int start = 0; start < numSamples; start += chunkSize)
+        {
+            const int count = juce::jmin(chunkSize, numSamples - start);
+            lfo.render(lfoValues, count);
+
+            for (int j = 0; j < count; ++j)
+            {
+                const float t = static_cast<float>(start + j + 1);
+                const float m = currentModulation + dModulation * t;
+                const float w = currentWidth + dWidth * t;
+                angle = (currentAngle + dAngle * t) * (1.0f - m + m * lfoValues[j]);
+
+                const float c = SineTable::cos(angle);
+                const float s = SineTable::sin(angle);
+                const float direct = (1.0f + w) * 0.5f;
+                const float cross = (1.0f - w) * 0.5f;
+
+                const SampleType l = leftChannel[start + j];
+                const SampleType r = rightChannel[start + j];
+                leftChannel[start + j] = (c * direct - s * cross) * l + (c * cross - s * direct) * r;
+                rightChannel[start + j] = (s * direct + c * cross) * l + (s * cross + c * direct) * r;
+            }
+        }
+
+        // Leave the static path starting from where the last sample ended up
+        current = computeCoefficients(angle, newWidth);
+        currentAngle = newModulation > 0.0f ? newAngle : angle;
+        currentWidth = newWidth;
+        currentModulation = newModulation;
+    }
+
+    static constexpr double smoothingSeconds = 0.05;
+
+    juce::SmoothedValue<float> rotation { 0.0f };
+    juce::SmoothedValue<float> width { 1.0f };
+    juce::SmoothedValue<float> modulation { 0.0f };
+    Coefficients current;
+    float currentAngle = 0.0f, currentWidth = 1.0f, currentModulation = 0.0f;
+};
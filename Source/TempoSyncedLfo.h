@@ -0,0 +1,143 @@
+/*
+  ==============================================================================
+
+    TempoSyncedLfo.h
+    Created: 17 Oct 2026 1:06:44pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// One cycle of sin(), linearly interpolated. Used instead of std::sin/cos in
+// per-sample loops; the error is a few parts per million.
+struct SineTable
+{
+    static constexpr int size = 4096;
+
+    // sin(2 pi * cycles), any value of cycles
+    static float lookup(float cycles)
+    {
+        const auto& table = get();
+
+        const float position = cycles * size;
+        const float floored = std::floor(position);
+        const int index = static_cast<int>(floored) & (size - 1);
+        const float frac = position - floored;
+
+        return table[(size_t) index] + frac * (table[(size_t) index + 1] - table[(size_t) index]);
+    }
+
+    static float sin(float radians) { return lookup(radians * inverseTwoPi); }
+    static float cos(float radians) { return lookup(radians * inverseTwoPi + 0.25f); }
+
+    // Builds the table; call once off the audio thread
+    static const std::array<float, size + 1>& get()
+    {
+        static const std::array<float, size + 1> table = []
+        {
+            std::array<float, size + 1> t {};
+            for (int i = 0; i <= size; ++i)
+                t[(size_t) i] = static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * i / size));
+            return t;
+        }();
+
+        return table;
+    }
+
+    static constexpr float inverseTwoPi = 1.0f / juce::MathConstants<float>::twoPi;
+};
+
+// Sine LFO locked to the host's musical position. The phase is taken from
+// the playhead's PPQ position at the start of every block and advanced per
+// sample from there, wrapping at the loop end if the loop restarts inside
+// the block. JUCE only reports position and tempo once per block, so a
+// tempo change takes effect at the next block boundary. While the transport
+// is stopped the LFO free-runs at the last known tempo.
+class TempoSyncedLfo
+{
+public:
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        ppq = 0.0;
+        looping = false;
+        SineTable::get();
+        updateIncrement();
+    }
+
+    // Cycle length in quarter notes
+    void setCycleLength(double quarterNotes) { cycleLength = juce::jmax(1.0 / 16.0, quarterNotes); }
+
+    // Audio thread, once per block before render()/skip()
+    void sync(juce::AudioPlayHead* playHead)
+    {
+        looping = false;
+
+        if (auto position = playHead != nullptr ? playHead->getPosition() : juce::Optional<juce::AudioPlayHead::PositionInfo>())
+        {
+            if (auto bpm = position->getBpm(); bpm.hasValue() && *bpm > 0.0)
+                tempo = *bpm;
+
+            if (position->getIsPlaying())
+            {
+                if (auto ppqPosition = position->getPpqPosition())
+                    ppq = *ppqPosition;
+
+                if (auto loop = position->getLoopPoints(); position->getIsLooping() && loop.hasValue() && loop->ppqEnd > loop->ppqStart)
+                {
+                    looping = true;
+                    loopStart = loop->ppqStart;
+                    loopEnd = loop->ppqEnd;
+                }
+            }
+        }
+
+        updateIncrement();
+    }
+
+    // sin(2 pi * phase) for the next numSamples samples
+    void render(float* output, int numSamples)
+    {
+        const double cyclesPerQuarter = 1.0 / cycleLength;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double cycles = ppq * cyclesPerQuarter;
+            output[i] = SineTable::lookup(static_cast<float>(cycles - std::floor(cycles)));
+            advance();
+        }
+    }
+
+    void skip(int numSamples)
+    {
+        const double previous = ppq;
+        ppq += numSamples * ppqPerSample;
+
+        if (looping && ppq >= loopEnd && previous < loopEnd)
+            ppq = loopStart + std::fmod(ppq - loopEnd, loopEnd - loopStart);
+    }
+
+private:
+    void updateIncrement() { ppqPerSample = tempo / (60.0 * sampleRate); }
+
+    void advance()
+    {
+        const double previous = ppq;
+        ppq += ppqPerSample;
+
+        // Only a crossing wraps, so a playhead that is already past the loop end keeps going
+        if (looping && ppq >= loopEnd && previous < loopEnd)
+            ppq -= loopEnd - loopStart;
+    }
+
+    double sampleRate = 44100.0;
+    double tempo = 120.0;
+    double cycleLength = 4.0;
+    double ppq = 0.0, ppqPerSample = 0.0;
+
+    bool looping = false;
+    double loopStart = 0.0, loopEnd = 0.0;
+};
@@ -1,108 +1,315 @@
-/*
-  ==============================================================================
-
-    VectorscopeComponent.cpp
-    Created: 15 Mar 2025 1:06:23pm
-    Author:  Zachary Pennington
-
-  ==============================================================================
-*/
-
-#include "VectorscopeComponent.h"
-
-VectorscopeComponent::VectorscopeComponent()
-{
-    sampleBuffer.setSize(2, bufferSize);
-    sampleBuffer.clear();
-    writePosition = 0;
-    startTimerHz(30);
-}
-
-VectorscopeComponent::~VectorscopeComponent()
-{
-    stopTimer();
-}
-
-void VectorscopeComponent::pushSamples(const float* leftSamples, const float* rightSamples, int numSamples)
-{
-//    // Ensure we don't exceed buffer size
-    int samplesToWrite = juce::jmin(numSamples, bufferSize - writePosition);
-    
-//    DBG(static_cast<juce::String>(samplesToWrite) + " -- CURRENT BUFFER SIZE --"); //1024
-
-    // Copy samples into the buffer
-    sampleBuffer.copyFrom(0, writePosition, leftSamples, samplesToWrite); // Left channel
-    sampleBuffer.copyFrom(1, writePosition, rightSamples, samplesToWrite); // Right channel
-
-    writePosition += samplesToWrite;
-    if (writePosition >= bufferSize)
-        writePosition = 0; // Wrap around
-    
-    // USE FOR MONO SIGNAL GEN.
-//    for (int i = 0; i < samplesToWrite; ++i)
-//    {
-//        float monoValue = std::sin(2.0f * juce::MathConstants<float>::pi * i / samplesToWrite);
-//        sampleBuffer.setSample(0, writePosition + i, monoValue);
-//        sampleBuffer.setSample(1, writePosition + i, monoValue);
-//    }
-}
-
-
-void VectorscopeComponent::paint(juce::Graphics& g)
-{
-    g.fillAll(juce::Colours::transparentBlack); // Background
-
-    // Center of the component
-    float centerX = getWidth() / 2.0f;
-    float centerY = getHeight() / 2.0f;
-    float scale = juce::jmin(getWidth(), getHeight()) * 0.45f; // Scale to fit
-
-    // Draw grid or axes
-//    g.setColour(juce::Colours::red);
-//    g.drawLine(centerX, 0, centerX, getHeight(), 1.0f); // Vertical axis (mono reference)
-//    g.drawLine(0, centerY, getWidth(), centerY, 1.0f);  // Horizontal axis
-
-    // Plot the vectorscope
-    juce::Path path;
-    bool firstPoint = true;
-
-    for (int i = 0; i < bufferSize; ++i)
-    {
-        
-        /*
-         ===============================================================================================
-         TODO: For some reason, switching the left and right channels below fixes the issue where
-         the channels were being drawn backwards when soloed. Need to figure out why this was happenning.
-         ===============================================================================================
-        */
-        
-        float right = sampleBuffer.getSample(0, i);  // Left channel
-        float left = sampleBuffer.getSample(1, i); // Right channel
-
-        // Rotated coordinates (45-degree turn)
-        float stereoDiff = (left - right) * 0.7071f; // ≈ 1/√2, horizontal spread
-        float monoSum = (left + right) * 0.7071f;    // ≈ 1/√2, vertical movement
-
-        float x = centerX + (stereoDiff * scale);    // X varies with stereo difference
-        float y = centerY - (monoSum * scale);       // Y varies with mono sum
-
-        if (firstPoint) { path.startNewSubPath(x, y); firstPoint = false; }
-        else { path.lineTo(x, y); }
-    }
-    
-    // Radial gradient from center
-    juce::ColourGradient gradient(juce::Colours::white, centerX, centerY,
-                                 juce::Colours::cyan, centerX + scale, centerY, true);
-    g.setGradientFill(gradient);
-
-    g.strokePath(path, juce::PathStrokeType(1.0f));
-}
-
-void VectorscopeComponent::resized()
-{
-}
-
-void VectorscopeComponent::timerCallback()
-{
-    repaint();
-}
+/*
+  ==============================================================================
+
+    VectorscopeComponent.cpp
+    Created: 15 Mar 2025 1:06:23pm
+    Author:  Zachary Pennington
+
+  ==============================================================================
+*/
+
+#include "VectorscopeComponent.h"
+
+VectorscopeComponent::VectorscopeComponent(ScopeFifo& fifo)
+: juce::Thread("Vectorscope Renderer"), scopeFifo(fifo)
+{
+    sampleBuffer.setSize(2, bufferSize);
+    sampleBuffer.clear();
+    writePosition = 0;
+    
+    // Sparse hits fade in as cyan, dense areas saturate towards white
+    for (int i = 0; i < lutSize; ++i)
+    {
+        float t = static_cast<float>(i) / (lutSize - 1);
+        colourLut[(size_t) i] = juce::Colours::cyan.interpolatedWith(juce::Colours::white, t * t)
+                                                    .withAlpha(t).getPixelARGB();
+    }
+    
+    startThread(juce::Thread::Priority::low);
+}
+
+VectorscopeComponent::~VectorscopeComponent()
+{
+    stopThread(1000);
+}
+
+void VectorscopeComponent::setPersistenceEnabled(bool shouldBeEnabled)
+{
+    persistenceEnabled.store(shouldBeEnabled);
+    clearDensity.store(true);
+    redrawRequested.store(true);
+}
+
+void VectorscopeComponent::setDisplayMode(ScopeMode newMode)
+{
+    displayMode.store(newMode);
+    clearDensity.store(true);
+    redrawRequested.store(true);
+}
+
+void VectorscopeComponent::paint(juce::Graphics& g)
+{
+    // Take over the worker's latest frame; the old front becomes its next target
+    if (frameReady.load())
+    {
+        frontFrame.store(1 - frontFrame.load());
+        frameReady.store(false);
+        notify();
+    }
+    
+    const auto& frame = frames[(size_t) frontFrame.load()];
+    
+    if (frame.isValid())
+        g.drawImage(frame, getLocalBounds().toFloat());
+}
+
+void VectorscopeComponent::resized()
+{
+    // Rendered at the display's scale so the trace stays sharp on high-DPI screens
+    float scale = juce::Component::getApproximateScaleFactorForComponent(this);
+    frameScale.store(scale);
+    frameWidth.store(juce::jmax(1, juce::roundToInt(getWidth() * scale)));
+    frameHeight.store(juce::jmax(1, juce::roundToInt(getHeight() * scale)));
+    redrawRequested.store(true);
+}
+
+bool VectorscopeComponent::refresh()
+{
+    if (frameReady.load())
+    {
+        repaint();
+        return true;
+    }
+    
+    // Nothing arrived and the last frame matched the one before: the worker can sleep
+    if (scopeFifo.getNumReady() > 0 || changing.load() || redrawRequested.load())
+        notify();
+    
+    return changing.load();
+}
+
+void VectorscopeComponent::renderOffscreen(juce::Image& target)
+{
+    frameWidth.store(target.getWidth());
+    frameHeight.store(target.getHeight());
+    redrawRequested.store(true);
+    renderFrame(target);
+}
+
+void VectorscopeComponent::run()
+{
+    while (! threadShouldExit())
+    {
+        // Only refresh() and paint() wake it; the timeout is just for checking threadShouldExit()
+        if (! wait(100))
+            continue;
+        
+        // paint() hasn't picked up the last frame yet, so both images are spoken for
+        if (frameReady.load() || threadShouldExit())
+            continue;
+        
+        auto& target = frames[(size_t) (1 - frontFrame.load())];
+        const bool drawn = renderFrame(target);
+        changing.store(drawn);
+        
+        if (drawn)
+            frameReady.store(true);
+    }
+}
+
+//==============================================================================
+bool VectorscopeComponent::renderFrame(juce::Image& target)
+{
+    int width = frameWidth.load();
+    int height = frameHeight.load();
+    
+    if (width == 0 || height == 0)
+        return false;
+    
+    bool changed = redrawRequested.exchange(false);
+    
+    if (target.getWidth() != width || target.getHeight() != height)
+        target = juce::Image(juce::Image::ARGB, width, height, true, juce::SoftwareImageType());
+    
+    bool persistence = persistenceEnabled.load();
+    frameMode = displayMode.load();
+    
+    if (persistence && (gridWidth != width || gridHeight != height || clearDensity.load()))
+    {
+        gridWidth = width;
+        gridHeight = height;
+        density.assign((size_t) (gridWidth * gridHeight), 0.0f);
+        clearDensity.store(false);
+    }
+    
+    // Faded by the time since the last frame, so it looks the same at any display rate
+    double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    double elapsed = juce::jlimit(0.0, 1.0, now - lastFrameTime);
+    lastFrameTime = now;
+    
+    if (persistence && densityVisible)
+        juce::FloatVectorOperations::multiply(density.data(), std::pow(decayPerFrame, static_cast<float>(elapsed * 30.0)),
+                                              static_cast<int>(density.size()));
+    
+    changed = drainFifo() || changed;
+    
+    if (persistence)
+    {
+        // Still fading out counts as a change
+        if (! changed && ! densityVisible)
+            return false;
+        
+        densityVisible = renderDensity(target);
+        return true;
+    }
+    
+    if (! changed)
+        return false;
+    
+    withScopeMode(frameMode, [&](auto mode) { renderPath<decltype(mode)::value>(target); });
+    return true;
+}
+
+bool VectorscopeComponent::drainFifo()
+{
+    // Anything older than one screen of history would be overwritten before it's drawn.
+    // Persistence wants every sample, so it keeps them all.
+    bool persistence = persistenceEnabled.load() && ! density.empty();
+    
+    int excess = scopeFifo.getNumReady() - bufferSize;
+    if (excess > 0 && ! persistence)
+        scopeFifo.discard(excess);
+    
+    bool changed = false;
+
+    while (scopeFifo.getNumReady() > 0)
+    {
+        int samplesToRead = juce::jmin(scopeFifo.getNumReady(), bufferSize - writePosition);
+        int samplesRead = scopeFifo.pull(sampleBuffer.getWritePointer(0, writePosition),
+                                         sampleBuffer.getWritePointer(1, writePosition),
+                                         samplesToRead);
+        
+        const auto* channel0 = sampleBuffer.getReadPointer(0, writePosition);
+        const auto* channel1 = sampleBuffer.getReadPointer(1, writePosition);
+        
+        bool silent = juce::FloatVectorOperations::findMinAndMax(channel0, samplesRead) == juce::Range<float>()
+                   && juce::FloatVectorOperations::findMinAndMax(channel1, samplesRead) == juce::Range<float>();
+        bool visible = ! silent || silentPoints < bufferSize;
+        silentPoints = silent ? juce::jmin(bufferSize, silentPoints + samplesRead) : 0;
+        changed = changed || visible;
+        
+        if (persistence && visible)
+        {
+            withScopeMode(frameMode, [&](auto mode)
+            {
+                accumulateDensity<decltype(mode)::value>(channel0, channel1, samplesRead);
+            });
+        }
+
+        writePosition += samplesRead;
+        if (writePosition >= bufferSize)
+            writePosition = 0; // Wrap around
+    }
+    
+    return changed;
+}
+
+template <ScopeMode mode>
+void VectorscopeComponent::renderPath(juce::Image& target)
+{
+    target.clear(target.getBounds());
+    juce::Graphics g(target);
+
+    const auto geometry = ScopeGeometry::forFrame<mode>(target.getWidth(), target.getHeight());
+
+    // Plot the vectorscope
+    juce::Path path;
+    bool firstPoint = true;
+    
+    int numPoints = juce::jlimit(1, bufferSize, scopeFifo.getPointsPerWindow());
+    int firstIndex = writePosition + bufferSize - numPoints;
+    
+    float x[batchSize], y[batchSize];
+
+    // Oldest sample first so the trace is continuous. Batches stop at the end
+    // of the circular history so each one is contiguous.
+    for (int done = 0; done < numPoints;)
+    {
+        int start = (firstIndex + done) % bufferSize;
+        int count = juce::jmin(batchSize, numPoints - done, bufferSize - start);
+        
+        transformScopePoints<mode>(sampleBuffer.getReadPointer(0, start), sampleBuffer.getReadPointer(1, start), x, y, count);
+        geometry.toPixels(x, y, count);
+        
+        for (int i = 0; i < count; ++i)
+        {
+            if constexpr (mode == ScopeMode::polarLevel)
+            {
+                // A ray per point; their ends trace the level at each angle
+                path.startNewSubPath(geometry.originX, geometry.originY);
+                path.lineTo(x[i], y[i]);
+            }
+            else
+            {
+                if (firstPoint) { path.startNewSubPath(x[i], y[i]); firstPoint = false; }
+                else { path.lineTo(x[i], y[i]); }
+            }
+        }
+        
+        done += count;
+    }
+    
+    // Radial gradient from the origin
+    juce::ColourGradient gradient(juce::Colours::white, geometry.originX, geometry.originY,
+                                  juce::Colours::cyan, geometry.originX + geometry.scale, geometry.originY, true);
+    g.setGradientFill(gradient);
+
+    g.strokePath(path, juce::PathStrokeType(frameScale.load()));
+}
+
+template <ScopeMode mode>
+void VectorscopeComponent::accumulateDensity(const float* channel0, const float* channel1, int numSamples)
+{
+    const auto geometry = ScopeGeometry::forFrame<mode>(gridWidth, gridHeight);
+    float x[batchSize], y[batchSize];
+
+    for (int start = 0; start < numSamples; start += batchSize)
+    {
+        int count = juce::jmin(batchSize, numSamples - start);
+        
+        transformScopePoints<mode>(channel0 + start, channel1 + start, x, y, count);
+        geometry.toPixels(x, y, count);
+        
+        for (int i = 0; i < count; ++i)
+        {
+            int px = static_cast<int>(x[i]);
+            int py = static_cast<int>(y[i]);
+
+            if (juce::isPositiveAndBelow(px, gridWidth) && juce::isPositiveAndBelow(py, gridHeight))
+                density[(size_t) (py * gridWidth + px)] += 1.0f;
+        }
+    }
+}
+
+bool VectorscopeComponent::renderDensity(juce::Image& target)
+{
+    // A handful of hits on one pixel is already clearly visible
+    constexpr float hitsForFullScale = 24.0f;
+    constexpr float lutScale = (lutSize - 1) / hitsForFullScale;
+
+    juce::Image::BitmapData pixels(target, juce::Image::BitmapData::writeOnly);
+    float peak = 0.0f;
+
+    for (int y = 0; y < gridHeight; ++y)
+    {
+        auto* line = reinterpret_cast<juce::PixelARGB*>(pixels.getLinePointer(y));
+        const float* row = density.data() + (size_t) (y * gridWidth);
+
+        for (int x = 0; x < gridWidth; ++x)
+            line[x] = colourLut[(size_t) juce::jmin(lutSize - 1, static_cast<int>(row[x] * lutScale))];
+        
+        peak = juce::jmax(peak, juce::FloatVectorOperations::findMaximum(row, gridWidth));
+    }
+    
+    return peak * lutScale >= 1.0f;
+}
@@ -1,35 +1,112 @@
-/*
-  ==============================================================================
-
-    VectorscopeComponent.h
-    Created: 15 Mar 2025 1:06:23pm
-    Author:  Zachary Pennington
-
-  ==============================================================================
-*/
-
-#pragma once
-#include <JuceHeader.h>
-
-class VectorscopeComponent : public juce::Component, public juce::Timer
-{
-public:
-    VectorscopeComponent();
-    ~VectorscopeComponent() override;
-
-    void paint(juce::Graphics& g) override;
-    void resized() override;
-
-    // Called by the audio thread to push new samples
-    void pushSamples(const float* leftSamples, const float* rightSamples, int numSamples);
-
-private:
-    void timerCallback() override;
-
-    // Buffer to store audio samples
-    juce::AudioBuffer<float> sampleBuffer;
-    int writePosition = 0;
-    static constexpr int bufferSize = 1024; // Adjust based on needs
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VectorscopeComponent)
-};
+/*
+  ==============================================================================
+
+    VectorscopeComponent.h
+    Created: 15 Mar 2025 1:06:23pm
+    Author:  Zachary Pennington
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "ScopeFifo.h"
+#include "ScopeDisplayModes.h"
+
+// The scope is rasterised on its own thread. The worker drains the FIFO and
+// draws into whichever of two images is not on screen, then publishes it;
+// paint() on the message thread only ever blits the front image. Frames are
+// paced by the editor's refresh() calls; a frame that would look the same as
+// the one on screen is not drawn at all.
+class VectorscopeComponent : public juce::Component, private juce::Thread
+{
+public:
+    explicit VectorscopeComponent(ScopeFifo& fifo);
+    ~VectorscopeComponent() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    
+    // Phosphor-style display: every sample lands in a decaying density grid
+    // instead of only the last bufferSize samples being stroked as a path.
+    void setPersistenceEnabled(bool shouldBeEnabled);
+    bool isPersistenceEnabled() const { return persistenceEnabled.load(); }
+    
+    void setDisplayMode(ScopeMode newMode);
+    ScopeMode getDisplayMode() const { return displayMode.load(); }
+    
+    // Once per display frame, from the editor. Returns true while the picture
+    // is still changing: new audio, or a persistence image fading out.
+    bool refresh();
+    
+    // Draws one frame into target on the calling thread, for the benchmark.
+    // Only while the component isn't on screen: nothing may be calling
+    // refresh() or paint(), or the worker would render at the same time.
+    void renderOffscreen(juce::Image& target);
+
+private:
+    void run() override;
+    
+    //==========================================================================
+    // Render thread only
+    
+    // Moves whatever the processor has pushed since the last frame into
+    // sampleBuffer. Returns false if none of it changes what is drawn.
+    bool drainFifo();
+    
+    // False if the frame would be identical to the one on screen; target is left alone then
+    bool renderFrame(juce::Image& target);
+    
+    // Returns false once the whole grid has faded to the LUT's first entry
+    bool renderDensity(juce::Image& target);
+    
+    // One instantiation per ScopeMode; frameMode picks which runs
+    template <ScopeMode mode> void renderPath(juce::Image& target);
+    template <ScopeMode mode> void accumulateDensity(const float* channel0, const float* channel1, int numSamples);
+    
+    // Points are transformed this many at a time
+    static constexpr int batchSize = 256;
+    ScopeMode frameMode = ScopeMode::lissajous;
+    
+    ScopeFifo& scopeFifo;
+
+    // Circular history of the most recent points, oldest at writePosition.
+    // Only the last scopeFifo.getPointsPerWindow() of them are drawn.
+    juce::AudioBuffer<float> sampleBuffer;
+    int writePosition = 0;
+    static constexpr int bufferSize = ScopeFifo::maxPointsPerWindow;
+    
+    // Exact zeros at the end of the history; once it is all silence, more
+    // silence (a stopped transport) leaves the picture as it is
+    int silentPoints = 0;
+    
+    // Persistence mode: one float cell per pixel, decayed every frame and
+    // mapped through colourLut into the frame
+    std::vector<float> density;
+    int gridWidth = 0, gridHeight = 0;
+    
+    static constexpr int lutSize = 256;
+    static constexpr float decayPerFrame = 0.9f; // per 1/30 s, whatever the display rate
+    double lastFrameTime = 0.0;
+    bool densityVisible = false;
+    std::array<juce::PixelARGB, lutSize> colourLut;
+    
+    //==========================================================================
+    // Shared between the threads
+    
+    // frames[frontFrame] belongs to paint(), the other one to the worker.
+    // frameReady hands the worker's finished frame over; only paint() flips.
+    std::array<juce::Image, 2> frames;
+    std::atomic<int> frontFrame { 0 };
+    std::atomic<bool> frameReady { false };
+    
+    std::atomic<int> frameWidth { 0 }, frameHeight { 0 }; // Physical pixels
+    std::atomic<float> frameScale { 1.0f };
+    std::atomic<bool> persistenceEnabled { false };
+    std::atomic<ScopeMode> displayMode { ScopeMode::lissajous };
+    std::atomic<bool> clearDensity { false };
+    std::atomic<bool> redrawRequested { true };  // size, mode or style changed
+    std::atomic<bool> changing { true };         // the last frame differed from the one before
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VectorscopeComponent)
+};
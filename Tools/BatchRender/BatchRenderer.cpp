@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.cpp
+    Created: 17 Oct 2026 12:53:24pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+#include "OutputNames.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    void setParameter(VectorScopeAudioProcessor& processor, const juce::String& parameterID, float value)
+    {
+        if (auto* param = processor.apvts.getParameter(parameterID))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+}
+
+BatchRenderer::BatchRenderer(Settings settingsToUse)
+: settings(std::move(settingsToUse))
+{
+    formatManager.registerBasicFormats();
+}
+
+std::vector<BatchRenderer::Result> BatchRenderer::render(const juce::Array<juce::File>& inputs)
+{
+    std::vector<Result> results((size_t) inputs.size());
+    std::atomic<int> nextFile { 0 };
+
+    // Settled up front, as workers running in parallel would otherwise
+    // overwrite each other's output
+    const auto outputNames = makeOutputNames(inputs);
+
+    for (int index = 0; index < inputs.size(); ++index)
+    {
+        if (outputNames[index].isEmpty())
+        {
+            results[(size_t) index].input = inputs[index];
+            results[(size_t) index].error = "listed more than once; rendered for its first entry only";
+        }
+    }
+
+    int numWorkers = juce::jlimit(1, juce::jmax(1, inputs.size()), settings.numThreads);
+    juce::ThreadPool pool(numWorkers);
+
+    // Each job is one worker: it owns a processor and keeps taking the next
+    // unclaimed file until the list is exhausted.
+    for (int worker = 0; worker < numWorkers; ++worker)
+    {
+        pool.addJob([this, &inputs, &outputNames, &results, &nextFile]
+        {
+            VectorScopeAudioProcessor processor;
+
+            for (int index = nextFile++; index < inputs.size(); index = nextFile++)
+                if (outputNames[index].isNotEmpty())
+                    results[(size_t) index] = renderFile(processor, inputs[index], outputNames[index]);
+        });
+    }
+
+    while (pool.getNumJobs() > 0)
+        juce::Thread::sleep(20);
+
+    return results;
+}
+
+BatchRenderer::Result BatchRenderer::renderFile(VectorScopeAudioProcessor& processor, const juce::File& input, const juce::String& outputName)
+{
+    Result result;
+    result.input = input;
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+    if (reader == nullptr)
+    {
+        result.error = "unreadable or unsupported format";
+        return result;
+    }
+
+    int numChannels = static_cast<int>(reader->numChannels);
+    auto layout = numChannels == 12 ? juce::AudioChannelSet::create7point1point4()
+                                    : juce::AudioChannelSet::canonicalChannelSet(numChannels);
+
+    VectorScopeAudioProcessor::BusesLayout buses;
+    buses.inputBuses.add(layout);
+    buses.outputBuses.add(layout);
+
+    if (! processor.setBusesLayout(buses))
+    {
+        result.error = "unsupported channel count (" + juce::String(numChannels) + ")";
+        return result;
+    }
+
+    auto* format = formatManager.findFormatForFileExtension(input.getFileExtension());
+    result.output = settings.outputDirectory.getChildFile(outputName + "_imaged" + input.getFileExtension());
+    result.output.deleteFile();
+
+    std::unique_ptr<juce::FileOutputStream> stream(result.output.createOutputStream());
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    if (format != nullptr && stream != nullptr)
+        writer.reset(format->createWriterFor(stream.get(), reader->sampleRate, reader->numChannels,
+                                             static_cast<int>(reader->bitsPerSample), {}, 0));
+
+    if (writer == nullptr)
+    {
+        result.error = "could not create " + result.output.getFullPathName();
+        return result;
+    }
+
+    stream.release(); // now owned by the writer
+
+    // Fresh state for every file so nothing carries over from the previous one
+    processor.setRateAndBufferSizeDetails(reader->sampleRate, settings.blockSize);
+    setParameter(processor, "soloLeft", settings.soloLeft ? 1.0f : 0.0f);
+    setParameter(processor, "soloCenter", settings.soloCenter ? 1.0f : 0.0f);
+    setParameter(processor, "soloRight", settings.soloRight ? 1.0f : 0.0f);
+    setParameter(processor, "rotation", static_cast<float>(settings.rotation));
+    setParameter(processor, "width", static_cast<float>(settings.width));
+    processor.prepareToPlay(reader->sampleRate, settings.blockSize);
+
+    juce::AudioBuffer<float> buffer(numChannels, settings.blockSize);
+    juce::MidiBuffer midi;
+
+    juce::int64 numBlocks = 0, outOfPhaseBlocks = 0;
+
+    for (juce::int64 position = 0; position < reader->lengthInSamples; position += settings.blockSize)
+    {
+        int numSamples = static_cast<int>(juce::jmin<juce::int64>(settings.blockSize, reader->lengthInSamples - position));
+        buffer.setSize(numChannels, numSamples, false, false, true);
+
+        reader->read(&buffer, 0, numSamples, position, true, true);
+        processor.processBlock(buffer, midi);
+        writer->writeFromAudioSampleBuffer(buffer, 0, numSamples);
+
+        float correlation = processor.correlationValue.load();
+        result.minimumCorrelation = juce::jmin(result.minimumCorrelation, correlation);
+        outOfPhaseBlocks += correlation < 0.0f ? 1 : 0;
+        ++numBlocks;
+    }
+
+    processor.releaseResources();
+
+    result.lengthSeconds = static_cast<double>(reader->lengthInSamples) / reader->sampleRate;
+    result.integratedCorrelation = processor.correlationIntegratedValue.load();
+    result.percentOutOfPhase = numBlocks > 0 ? 100.0f * static_cast<float>(outOfPhaseBlocks) / static_cast<float>(numBlocks) : 0.0f;
+    return result;
+}
+
+void BatchRenderer::writeReport(const std::vector<Result>& results, const juce::File& csvFile)
+{
+    juce::String csv = "file,output,seconds,integrated_correlation,minimum_correlation,percent_out_of_phase,error\n";
+
+    for (const auto& r : results)
+    {
+        csv << r.input.getFileName() << ","
+            << r.output.getFileName() << ","
+            << juce::String(r.lengthSeconds, 3) << ","
+            << juce::String(r.integratedCorrelation, 4) << ","
+            << juce::String(r.minimumCorrelation, 4) << ","
+            << juce::String(r.percentOutOfPhase, 2) << ","
+            << r.error << "\n";
+    }
+
+    csvFile.replaceWithText(csv);
+}
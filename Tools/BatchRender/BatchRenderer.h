@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.h
+    Created: 17 Oct 2026 12:53:24pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+class VectorScopeAudioProcessor;
+
+// Streams audio files through VectorScopeAudioProcessor outside a host.
+// Files are spread over a pool of workers, each owning one processor
+// instance that is re-prepared for every file it picks up.
+class BatchRenderer
+{
+public:
+    struct Settings
+    {
+        juce::File outputDirectory;
+        int blockSize = 512;
+        int numThreads = juce::SystemStats::getNumCpus();
+
+        bool soloLeft = false;
+        bool soloCenter = false;
+        bool soloRight = false;
+        int rotation = 0;   // degrees
+        int width = 100;    // percent
+    };
+
+    struct Result
+    {
+        juce::File input, output;
+        juce::String error;         // empty on success
+
+        double lengthSeconds = 0.0;
+        float integratedCorrelation = 0.0f;
+        float minimumCorrelation = 1.0f;    // lowest 300 ms reading
+        float percentOutOfPhase = 0.0f;     // share of blocks with a negative 300 ms reading
+    };
+
+    explicit BatchRenderer(Settings settingsToUse);
+
+    // Blocks until every file has been rendered; results keep the input order.
+    // Inputs sharing a name are written as <name>_2_imaged, <name>_3_imaged...
+    std::vector<Result> render(const juce::Array<juce::File>& inputs);
+
+    // One line per file, suitable for a spreadsheet
+    static void writeReport(const std::vector<Result>& results, const juce::File& csvFile);
+
+private:
+    Result renderFile(VectorScopeAudioProcessor& processor, const juce::File& input, const juce::String& outputName);
+
+    Settings settings;
+    juce::AudioFormatManager formatManager;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BatchRenderer)
+};
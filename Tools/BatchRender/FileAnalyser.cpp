@@ -0,0 +1,231 @@
+/*
+  ==============================================================================
+
+    FileAnalyser.cpp
+    Created: 17 Oct 2026 1:20:11pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#include "FileAnalyser.h"
+#include "OutputNames.h"
+
+FileAnalyser::FileAnalyser(Settings settingsToUse)
+: settings(std::move(settingsToUse))
+{
+    formatManager.registerBasicFormats();
+}
+
+std::vector<FileAnalyser::Result> FileAnalyser::analyse(const juce::Array<juce::File>& inputs)
+{
+    std::vector<Result> results;
+    juce::ThreadPool pool(juce::jmax(1, settings.numThreads));
+    const auto outputNames = makeOutputNames(inputs);
+
+    for (int index = 0; index < inputs.size(); ++index)
+    {
+        if (outputNames[index].isEmpty())
+        {
+            Result duplicate;
+            duplicate.input = inputs[index];
+            duplicate.error = "listed more than once; analysed for its first entry only";
+            results.push_back(duplicate);
+            continue;
+        }
+
+        results.push_back(analyseFile(pool, inputs[index]));
+        results.back().outputName = outputNames[index];
+    }
+
+    return results;
+}
+
+FileAnalyser::Result FileAnalyser::analyseFile(juce::ThreadPool& pool, const juce::File& input)
+{
+    Result result;
+    result.input = input;
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+    if (reader == nullptr || reader->sampleRate <= 0.0)
+    {
+        result.error = "unreadable or unsupported format";
+        return result;
+    }
+
+    const auto length = reader->lengthInSamples;
+    const auto windowLength = juce::jmax<juce::int64>(1, static_cast<juce::int64>(std::round(reader->sampleRate * settings.windowSeconds)));
+    const int numWindows = static_cast<int>((length + windowLength - 1) / windowLength);
+    const int numChunks = (numWindows + windowsPerChunk - 1) / windowsPerChunk;
+
+    result.lengthSeconds = static_cast<double>(length) / reader->sampleRate;
+
+    //==========================================================================
+    // Map: each chunk fills its own slice of sums, so the workers never share
+    // anything but the chunk counter. Every worker opens its own reader.
+    std::vector<Sums> sums((size_t) numWindows);
+    std::atomic<int> nextChunk { 0 };
+    std::atomic<bool> failed { false };
+
+    const int numWorkers = juce::jlimit(1, juce::jmax(1, numChunks), pool.getNumThreads());
+
+    for (int worker = 0; worker < numWorkers; ++worker)
+    {
+        pool.addJob([this, &input, &sums, &nextChunk, &failed, numChunks, windowLength]
+        {
+            std::unique_ptr<juce::AudioFormatReader> workerReader(formatManager.createReaderFor(input));
+            if (workerReader == nullptr)
+            {
+                failed = true;
+                return;
+            }
+
+            juce::AudioBuffer<float> buffer(static_cast<int>(workerReader->numChannels), static_cast<int>(windowLength));
+
+            for (int chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+                analyseChunk(*workerReader, chunk, windowLength, buffer, sums);
+        });
+    }
+
+    while (pool.getNumJobs() > 0)
+        juce::Thread::sleep(5);
+
+    if (failed)
+    {
+        result.error = "could not open the file on every thread";
+        return result;
+    }
+
+    //==========================================================================
+    // Reduce, in window order
+    Sums total;
+    double widthSum = 0.0;
+    int numAudible = 0, numOutOfPhase = 0;
+
+    result.windows.reserve(sums.size());
+
+    for (int index = 0; index < numWindows; ++index)
+    {
+        const auto& s = sums[(size_t) index];
+        total.add(s);
+
+        auto window = summarise(s);
+        window.startSeconds = static_cast<double>(index * windowLength) / reader->sampleRate;
+        result.windows.push_back(window);
+
+        if (window.silent)
+            continue;
+
+        ++numAudible;
+        numOutOfPhase += window.correlation < 0.0f ? 1 : 0;
+        widthSum += window.width;
+
+        const int bin = juce::jlimit(0, numHistogramBins - 1, static_cast<int>((window.correlation + 1.0f) * 0.5f * numHistogramBins));
+        ++result.histogram[(size_t) bin];
+    }
+
+    result.correlation = summarise(total).correlation;
+    result.meanWidth = numAudible > 0 ? static_cast<float>(widthSum / numAudible) : 0.0f;
+    result.percentOutOfPhase = numAudible > 0 ? 100.0f * static_cast<float>(numOutOfPhase) / static_cast<float>(numAudible) : 0.0f;
+
+    // Ties go to the earlier window so the order is fully determined
+    for (const auto& window : result.windows)
+        if (! window.silent)
+            result.worstWindows.push_back(window);
+
+    auto byCorrelation = [](const Window& a, const Window& b)
+    {
+        return a.correlation != b.correlation ? a.correlation < b.correlation : a.startSeconds < b.startSeconds;
+    };
+
+    const auto numWorst = (size_t) juce::jmin((int) result.worstWindows.size(), juce::jmax(0, settings.numWorstWindows));
+    std::partial_sort(result.worstWindows.begin(), result.worstWindows.begin() + (std::ptrdiff_t) numWorst, result.worstWindows.end(), byCorrelation);
+    result.worstWindows.resize(numWorst);
+
+    return result;
+}
+
+void FileAnalyser::analyseChunk(juce::AudioFormatReader& reader, int chunk, juce::int64 windowLength,
+                                juce::AudioBuffer<float>& buffer, std::vector<Sums>& sums) const
+{
+    const int firstWindow = chunk * windowsPerChunk;
+    const int lastWindow = juce::jmin(firstWindow + windowsPerChunk, (int) sums.size());
+
+    for (int index = firstWindow; index < lastWindow; ++index)
+    {
+        const auto start = index * windowLength;
+        const int numSamples = static_cast<int>(juce::jmin(windowLength, reader.lengthInSamples - start));
+
+        reader.read(&buffer, 0, numSamples, start, true, true);
+
+        // Mono files are analysed as identical left and right
+        const float* left = buffer.getReadPointer(0);
+        const float* right = buffer.getReadPointer(buffer.getNumChannels() > 1 ? 1 : 0);
+
+        sums[(size_t) index] = VectorScopeAudioProcessor::sumStereoProducts(left, right, numSamples);
+    }
+}
+
+FileAnalyser::Window FileAnalyser::summarise(const Sums& sums)
+{
+    Window window;
+
+    const double energy = sums.ll + sums.rr;
+    window.silent = sums.numSamples == 0 || energy / (2.0 * static_cast<double>(sums.numSamples)) < 1.0e-6; // -60 dBFS
+
+    window.correlation = sums.getCorrelation();
+
+    // Side over mid + side energy, scaled so mono is 0 % and fully out of phase 200 %
+    window.width = energy > 0.0 ? static_cast<float>(100.0 * (1.0 - 2.0 * sums.lr / energy)) : 0.0f;
+
+    return window;
+}
+
+void FileAnalyser::writeReport(const std::vector<Result>& results, const juce::File& directory)
+{
+    juce::String csv = "file,windows,seconds,correlation,percent_out_of_phase,mean_width,worst_windows";
+
+    for (int bin = 0; bin < numHistogramBins; ++bin)
+        csv << ",hist_" << juce::String(-1.0f + 2.0f * bin / numHistogramBins, 1);
+
+    csv << ",error\n";
+
+    for (const auto& r : results)
+    {
+        juce::StringArray worst;
+        for (const auto& w : r.worstWindows)
+            worst.add(juce::String(w.startSeconds, 3) + "s " + juce::String(w.correlation, 3));
+
+        const auto windowsFile = r.error.isEmpty() ? r.outputName + "_windows.csv" : juce::String();
+
+        csv << r.input.getFileName() << ","
+            << windowsFile << ","
+            << juce::String(r.lengthSeconds, 3) << ","
+            << juce::String(r.correlation, 4) << ","
+            << juce::String(r.percentOutOfPhase, 2) << ","
+            << juce::String(r.meanWidth, 1) << ","
+            << worst.joinIntoString("; ");
+
+        for (auto count : r.histogram)
+            csv << "," << juce::String(count);
+
+        csv << "," << r.error << "\n";
+
+        if (r.error.isNotEmpty())
+            continue;
+
+        juce::String windows = "start_seconds,correlation,width,silent\n";
+
+        for (const auto& w : r.windows)
+        {
+            windows << juce::String(w.startSeconds, 3) << ","
+                    << juce::String(w.correlation, 4) << ","
+                    << juce::String(w.width, 1) << ","
+                    << (w.silent ? 1 : 0) << "\n";
+        }
+
+        directory.getChildFile(windowsFile).replaceWithText(windows);
+    }
+
+    directory.getChildFile("analysis.csv").replaceWithText(csv);
+}
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    FileAnalyser.h
+    Created: 17 Oct 2026 1:20:11pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+// Whole-file stereo statistics for delivery QC, without rendering anything.
+//
+// A file is cut into fixed windows, and the windows into fixed chunks. The
+// chunks are analysed in parallel on a thread pool, each into its own slice
+// of per-window partial sums; everything is then merged in window order on
+// the calling thread. Chunk boundaries don't depend on the number of
+// threads, so neither do the results, down to the last bit.
+class FileAnalyser
+{
+public:
+    struct Settings
+    {
+        int numThreads = juce::SystemStats::getNumCpus();
+        double windowSeconds = 0.4;
+        int numWorstWindows = 10;
+    };
+
+    static constexpr int numHistogramBins = 20;    // correlation -1 to +1 in steps of 0.1
+
+    struct Window
+    {
+        double startSeconds = 0.0;
+        float correlation = 0.0f;
+        float width = 0.0f;         // 0 % mono, 100 % uncorrelated, 200 % out of phase
+        bool silent = true;         // below -60 dBFS; left out of the statistics
+    };
+
+    struct Result
+    {
+        juce::File input;
+        juce::String outputName;    // unique in the batch; names the windows file
+        juce::String error;         // empty on success
+
+        double lengthSeconds = 0.0;
+        float correlation = 0.0f;           // over the whole file
+        float meanWidth = 0.0f;             // of the non-silent windows
+        float percentOutOfPhase = 0.0f;     // share of non-silent windows with negative correlation
+        std::array<juce::uint32, numHistogramBins> histogram {};
+
+        std::vector<Window> windows;        // width and correlation over time
+        std::vector<Window> worstWindows;   // lowest correlation first
+    };
+
+    explicit FileAnalyser(Settings settingsToUse);
+
+    // Files one after the other, each one spread over all threads
+    std::vector<Result> analyse(const juce::Array<juce::File>& inputs);
+
+    // analysis.csv with one line per file, plus <file>_windows.csv per file.
+    // Inputs sharing a name get <file>_2_windows.csv, <file>_3_windows.csv...
+    static void writeReport(const std::vector<Result>& results, const juce::File& directory);
+
+private:
+    // Windows per chunk; the unit of work handed to a thread
+    static constexpr int windowsPerChunk = 64;
+
+    // Products of one window, reduced exactly as the plugin's meter does
+    using Sums = VectorScopeAudioProcessor::StereoSums;
+
+    Result analyseFile(juce::ThreadPool& pool, const juce::File& input);
+    void analyseChunk(juce::AudioFormatReader& reader, int chunk, juce::int64 windowLength,
+                      juce::AudioBuffer<float>& buffer, std::vector<Sums>& sums) const;
+
+    static Window summarise(const Sums& sums);
+
+    Settings settings;
+    juce::AudioFormatManager formatManager;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FileAnalyser)
+};
@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 17 Oct 2026 12:53:24pm
+    Author:  Ziptye Audio
+
+    Entry point of the headless batch renderer. This console target compiles
+    the plugin's Source/ files and BinaryData together with this folder.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "BatchRenderer.h"
+#include "FileAnalyser.h"
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: DiamondImagerBatch [options] <file or folder>...\n"
+                     "\n"
+                     "  --out=<folder>        where rendered files and report.csv go (default: ./rendered)\n"
+                     "  --block-size=<n>      samples per processBlock call (default: 512)\n"
+                     "  --threads=<n>         parallel workers (default: number of cores)\n"
+                     "  --solo=<L|C|R...>     solo combination, e.g. --solo=LR\n"
+                     "  --rotation=<0-100>    rotation in degrees (default: 0)\n"
+                     "  --width=<0-200>       width in percent (default: 100)\n"
+                     "\n"
+                     "  --analyse             only measure the inputs: correlation histogram, time out of\n"
+                     "                        phase, width over time and the worst windows (default --out: ./analysis)\n"
+                     "  --window-ms=<n>       analysis window (default: 400)\n"
+                     "  --worst=<n>           worst windows to list per file (default: 10)\n";
+    }
+
+    juce::String getOption(const juce::ArgumentList& args, const juce::String& name, const juce::String& fallback)
+    {
+        return args.containsOption(name) ? args.getValueForOption(name) : fallback;
+    }
+
+    int analyse(const juce::ArgumentList& args, const juce::Array<juce::File>& inputs)
+    {
+        FileAnalyser::Settings settings;
+        settings.numThreads = juce::jmax(1, getOption(args, "--threads", juce::String(settings.numThreads)).getIntValue());
+        settings.windowSeconds = juce::jlimit(10, 60000, getOption(args, "--window-ms", "400").getIntValue()) * 0.001;
+        settings.numWorstWindows = juce::jmax(0, getOption(args, "--worst", "10").getIntValue());
+
+        auto outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(getOption(args, "--out", "analysis"));
+        outputDirectory.createDirectory();
+
+        FileAnalyser analyser(settings);
+        auto startTime = juce::Time::getMillisecondCounterHiRes();
+        auto results = analyser.analyse(inputs);
+        auto elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+        FileAnalyser::writeReport(results, outputDirectory);
+
+        int failures = 0;
+        double audioSeconds = 0.0;
+
+        for (const auto& r : results)
+        {
+            if (r.error.isNotEmpty())
+            {
+                std::cerr << r.input.getFileName() << ": " << r.error << "\n";
+                ++failures;
+                continue;
+            }
+
+            audioSeconds += r.lengthSeconds;
+            std::cout << r.input.getFileName() << "  correlation " << juce::String(r.correlation, 3)
+                      << "  out of phase " << juce::String(r.percentOutOfPhase, 1) << "%"
+                      << "  width " << juce::String(r.meanWidth, 0) << "%\n";
+
+            for (const auto& w : r.worstWindows)
+                std::cout << "    " << juce::String(w.startSeconds, 3) << " s  " << juce::String(w.correlation, 3) << "\n";
+        }
+
+        std::cout << results.size() - (size_t) failures << " file(s), " << juce::String(audioSeconds, 1) << " s of audio in "
+                  << juce::String(elapsedSeconds, 2) << " s\n";
+
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    // Anything that isn't an option is an input; folders contribute their audio files
+    juce::Array<juce::File> inputs;
+    for (const auto& arg : args.arguments)
+    {
+        if (arg.isOption())
+            continue;
+
+        auto file = arg.resolveAsFile();
+        if (file.isDirectory())
+            inputs.addArray(file.findChildFiles(juce::File::findFiles, false, "*.wav;*.aif;*.aiff"));
+        else if (file.existsAsFile())
+            inputs.add(file);
+        else
+            std::cerr << "Skipping " << arg.text << ": not found\n";
+    }
+
+    if (inputs.isEmpty())
+    {
+        std::cerr << "No input files.\n";
+        return 1;
+    }
+
+    if (args.containsOption("--analyse"))
+        return analyse(args, inputs);
+
+    BatchRenderer::Settings settings;
+    settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(getOption(args, "--out", "rendered"));
+    settings.blockSize = juce::jlimit(1, 65536, getOption(args, "--block-size", "512").getIntValue());
+    settings.numThreads = juce::jmax(1, getOption(args, "--threads", juce::String(settings.numThreads)).getIntValue());
+    settings.rotation = juce::jlimit(0, 100, getOption(args, "--rotation", "0").getIntValue());
+    settings.width = juce::jlimit(0, 200, getOption(args, "--width", "100").getIntValue());
+
+    auto solo = getOption(args, "--solo", {}).toUpperCase();
+    settings.soloLeft = solo.containsChar('L');
+    settings.soloCenter = solo.containsChar('C');
+    settings.soloRight = solo.containsChar('R');
+
+    settings.outputDirectory.createDirectory();
+
+    BatchRenderer renderer(settings);
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+    auto results = renderer.render(inputs);
+    auto elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) * 0.001;
+
+    BatchRenderer::writeReport(results, settings.outputDirectory.getChildFile("report.csv"));
+
+    int failures = 0;
+    double audioSeconds = 0.0;
+
+    for (const auto& r : results)
+    {
+        if (r.error.isNotEmpty())
+        {
+            std::cerr << r.input.getFileName() << ": " << r.error << "\n";
+            ++failures;
+            continue;
+        }
+
+        audioSeconds += r.lengthSeconds;
+        std::cout << r.input.getFileName() << "  correlation " << juce::String(r.integratedCorrelation, 3)
+                  << "  min " << juce::String(r.minimumCorrelation, 3)
+                  << "  out of phase " << juce::String(r.percentOutOfPhase, 1) << "%\n";
+    }
+
+    std::cout << results.size() - (size_t) failures << " file(s), " << juce::String(audioSeconds, 1) << " s of audio in "
+              << juce::String(elapsedSeconds, 2) << " s\n";
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,42 @@
+/*
+  ==============================================================================
+
+    OutputNames.h
+    Created: 17 Oct 2026 2:01:11pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Base names for the files written per input, worked out before any worker
+// starts so that two of them never write to the same file. Inputs sharing a
+// name (from different folders, or differing only in case or extension) get
+// _2, _3, ... in input order. A file listed more than once gets an empty
+// name: only its first entry is processed.
+inline juce::StringArray makeOutputNames(const juce::Array<juce::File>& inputs)
+{
+    juce::StringArray names, taken;
+
+    for (int index = 0; index < inputs.size(); ++index)
+    {
+        if (inputs.indexOf(inputs[index]) < index)
+        {
+            names.add({});
+            continue;
+        }
+
+        const auto stem = inputs[index].getFileNameWithoutExtension();
+        auto name = stem;
+
+        for (int n = 2; taken.contains(name, true); ++n)
+            name = stem + "_" + juce::String(n);
+
+        taken.add(name);
+        names.add(name);
+    }
+
+    return names;
+}
@@ -0,0 +1,303 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 17 Oct 2026 1:33:52pm
+    Author:  Ziptye Audio
+
+    Console benchmark of the plugin's hot paths. Like the batch renderer,
+    this target compiles the plugin's Source/ files and BinaryData together
+    with this folder.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/VectorscopeComponent.h"
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: DiamondImagerBenchmark [options]\n"
+                     "\n"
+                     "  --seconds=<n>         audio timed per case (default: 1)\n"
+                     "  --frames=<n>          scope frames timed per case (default: 200)\n"
+                     "  --csv=<file>          also write every case to a CSV file\n";
+    }
+
+    juce::String getOption(const juce::ArgumentList& args, const juce::String& name, const juce::String& fallback)
+    {
+        return args.containsOption(name) ? args.getValueForOption(name) : fallback;
+    }
+
+    const double sampleRates[] { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    const int blockSizes[] { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+
+    // One timed case. The budget is the audio's own duration, so 100 % means
+    // this alone would use a whole core in real time.
+    struct Measurement
+    {
+        juce::String name;
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        juce::int64 numSamples = 0;
+        double seconds = 0.0;
+
+        double nanosecondsPerSample() const { return seconds * 1.0e9 / static_cast<double>(numSamples); }
+        double percentOfBudget() const      { return 100.0 * seconds * sampleRate / static_cast<double>(numSamples); }
+    };
+
+    class Report
+    {
+    public:
+        void add(const Measurement& m)
+        {
+            std::cout << m.name.paddedRight(' ', 34)
+                      << juce::String(m.sampleRate / 1000.0, 1).paddedLeft(' ', 7) << " kHz"
+                      << juce::String(m.blockSize).paddedLeft(' ', 6)
+                      << juce::String(m.nanosecondsPerSample(), 2).paddedLeft(' ', 11) << " ns/sample"
+                      << juce::String(m.percentOfBudget(), 3).paddedLeft(' ', 10) << " %\n";
+
+            csv << m.name << "," << m.sampleRate << "," << m.blockSize << ","
+                << juce::String(m.nanosecondsPerSample(), 3) << "," << juce::String(m.percentOfBudget(), 4) << "\n";
+        }
+
+        void write(const juce::File& file) const
+        {
+            file.replaceWithText("case,sample_rate,block_size,ns_per_sample,percent_of_budget\n" + csv);
+        }
+
+    private:
+        juce::String csv;
+    };
+
+    // Repeats body (which processes blockSize samples) until at least
+    // seconds of audio have gone through, after one untimed warm-up second
+    template <typename Body>
+    Measurement timeBlocks(const juce::String& name, double sampleRate, int blockSize, double seconds, Body&& body)
+    {
+        const auto blocksFor = [&](double s) { return juce::jmax<juce::int64>(16, static_cast<juce::int64>(s * sampleRate / blockSize)); };
+
+        for (juce::int64 i = 0, n = blocksFor(juce::jmin(1.0, seconds)); i < n; ++i)
+            body();
+
+        const auto numBlocks = blocksFor(seconds);
+        const auto start = juce::Time::getHighResolutionTicks();
+
+        for (juce::int64 i = 0; i < numBlocks; ++i)
+            body();
+
+        Measurement m;
+        m.name = name;
+        m.sampleRate = sampleRate;
+        m.blockSize = blockSize;
+        m.numSamples = numBlocks * blockSize;
+        m.seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        return m;
+    }
+
+    template <typename SampleType>
+    void fillWithNoise(juce::AudioBuffer<SampleType>& buffer, juce::Random& random)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(channel, i, static_cast<SampleType>(random.nextFloat() * 0.5f - 0.25f));
+    }
+
+    void setParameter(VectorScopeAudioProcessor& processor, const juce::String& parameterID, float value)
+    {
+        if (auto* param = processor.apvts.getParameter(parameterID))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    //==========================================================================
+    // processBlock for every solo combination, layout, rate and block size
+    template <typename SampleType>
+    void benchmarkProcessBlock(Report& report, double seconds)
+    {
+        const char* precision = std::is_same_v<SampleType, float> ? "float" : "double";
+        juce::Random random(1);
+        juce::MidiBuffer midi;
+
+        for (auto layout : { juce::AudioChannelSet::mono(), juce::AudioChannelSet::stereo() })
+        {
+            VectorScopeAudioProcessor processor;
+            VectorScopeAudioProcessor::BusesLayout buses;
+            buses.inputBuses.add(layout);
+            buses.outputBuses.add(layout);
+            processor.setBusesLayout(buses);
+            processor.setProcessingPrecision(std::is_same_v<SampleType, float> ? juce::AudioProcessor::singlePrecision
+                                                                               : juce::AudioProcessor::doublePrecision);
+
+            // Some rotation and width so the matrix isn't the identity
+            setParameter(processor, "rotation", 30.0f);
+            setParameter(processor, "width", 150.0f);
+
+            for (int solo = 0; solo < 8; ++solo)
+            {
+                setParameter(processor, "soloLeft", (solo & 1) != 0 ? 1.0f : 0.0f);
+                setParameter(processor, "soloCenter", (solo & 2) != 0 ? 1.0f : 0.0f);
+                setParameter(processor, "soloRight", (solo & 4) != 0 ? 1.0f : 0.0f);
+
+                juce::String soloName;
+                soloName << ((solo & 1) != 0 ? "L" : "") << ((solo & 2) != 0 ? "C" : "") << ((solo & 4) != 0 ? "R" : "");
+
+                const auto name = "processBlock " + juce::String(precision) + " " + layout.getDescription().upToFirstOccurrenceOf(" ", false, false).toLowerCase()
+                                + " solo " + (soloName.isEmpty() ? juce::String("off") : soloName);
+
+                for (auto sampleRate : sampleRates)
+                {
+                    for (auto blockSize : blockSizes)
+                    {
+                        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+                        processor.prepareToPlay(sampleRate, blockSize);
+
+                        juce::AudioBuffer<SampleType> source(layout.size(), blockSize), buffer(layout.size(), blockSize);
+                        fillWithNoise(source, random);
+
+                        report.add(timeBlocks(name, sampleRate, blockSize, seconds, [&]
+                        {
+                            buffer.makeCopyOf(source, true);
+                            processor.processBlock(buffer, midi);
+                        }));
+
+                        processor.releaseResources();
+                    }
+                }
+            }
+        }
+    }
+
+    //==========================================================================
+    // The analysis paths on their own, stereo at 48 kHz
+    void benchmarkAnalysis(Report& report, double seconds)
+    {
+        constexpr double sampleRate = 48000.0;
+        juce::Random random(2);
+
+        VectorScopeAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, 4096);
+        processor.prepareToPlay(sampleRate, 4096);
+
+        for (auto blockSize : blockSizes)
+        {
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            fillWithNoise(buffer, random);
+            const float* left = buffer.getReadPointer(0);
+            const float* right = buffer.getReadPointer(1);
+
+            CorrelationMeter meter;
+            meter.prepare(sampleRate);
+
+            report.add(timeBlocks("CorrelationMeter::process", sampleRate, blockSize, seconds, [&]
+            {
+                meter.process(left, right, blockSize);
+            }));
+
+            float sink = 0.0f;
+            report.add(timeBlocks("calculateStereoCorrelation", sampleRate, blockSize, seconds, [&]
+            {
+                sink += processor.calculateStereoCorrelation(left, right, blockSize);
+            }));
+            juce::ignoreUnused(sink);
+
+            // Nothing drains the FIFO here, so it is emptied as the editor would
+            report.add(timeBlocks("pushSamplesToEditor", sampleRate, blockSize, seconds, [&]
+            {
+                processor.pushSamplesToEditor(left, right, blockSize);
+                processor.scopeFifo.discard(processor.scopeFifo.getNumReady());
+            }));
+        }
+
+        processor.releaseResources();
+    }
+
+    //==========================================================================
+    // One scope frame per iteration, each with a full window of new points.
+    // The budget is a 60 Hz display frame.
+    void benchmarkScope(int numFrames, const juce::File& csvFile)
+    {
+        constexpr double frameBudgetMs = 1000.0 / 60.0;
+        juce::String csv = "mode,persistence,width,height,ms_per_frame,percent_of_frame\n";
+        juce::Random random(3);
+
+        ScopeFifo fifo;
+        VectorscopeComponent scope(fifo);
+
+        std::vector<float> left(ScopeFifo::maxPointsPerWindow), right(ScopeFifo::maxPointsPerWindow);
+        for (size_t i = 0; i < left.size(); ++i)
+        {
+            left[i] = random.nextFloat() * 2.0f - 1.0f;
+            right[i] = 0.7f * left[i] + 0.3f * (random.nextFloat() * 2.0f - 1.0f);
+        }
+
+        fifo.setPointsPerWindow(ScopeFifo::maxPointsPerWindow);
+
+        for (int mode = 0; mode < numScopeModes; ++mode)
+        {
+            for (bool persistence : { false, true })
+            {
+                // The editor's scope area at 1x and 2x
+                for (int scale : { 1, 2 })
+                {
+                    scope.setDisplayMode(static_cast<ScopeMode>(mode));
+                    scope.setPersistenceEnabled(persistence);
+                    juce::Image image(juce::Image::ARGB, 300 * scale, 300 * scale, true, juce::SoftwareImageType());
+
+                    double seconds = 0.0;
+                    for (int frame = 0; frame < numFrames; ++frame)
+                    {
+                        fifo.push(left.data(), right.data(), (int) left.size());
+
+                        const auto start = juce::Time::getHighResolutionTicks();
+                        scope.renderOffscreen(image);
+                        seconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                    }
+
+                    const double msPerFrame = seconds * 1000.0 / numFrames;
+                    const auto name = juce::String(getScopeModeName(static_cast<ScopeMode>(mode))) + (persistence ? " persistence" : "");
+
+                    std::cout << ("scope " + name).paddedRight(' ', 34)
+                              << (juce::String(image.getWidth()) + "x" + juce::String(image.getHeight())).paddedLeft(' ', 11)
+                              << juce::String(msPerFrame, 3).paddedLeft(' ', 17) << " ms/frame"
+                              << juce::String(100.0 * msPerFrame / frameBudgetMs, 2).paddedLeft(' ', 11) << " %\n";
+
+                    csv << name << "," << (persistence ? 1 : 0) << "," << image.getWidth() << "," << image.getHeight() << ","
+                        << juce::String(msPerFrame, 4) << "," << juce::String(100.0 * msPerFrame / frameBudgetMs, 3) << "\n";
+                }
+            }
+        }
+
+        if (csvFile != juce::File())
+            csvFile.getSiblingFile(csvFile.getFileNameWithoutExtension() + "_scope.csv").replaceWithText(csv);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    const double seconds = juce::jlimit(0.05, 60.0, getOption(args, "--seconds", "1").getDoubleValue());
+    const int numFrames = juce::jlimit(1, 100000, getOption(args, "--frames", "200").getIntValue());
+    const auto csvFile = args.containsOption("--csv") ? args.getFileForOption("--csv") : juce::File();
+
+    Report report;
+    benchmarkProcessBlock<float>(report, seconds);
+    benchmarkProcessBlock<double>(report, seconds);
+    benchmarkAnalysis(report, seconds);
+    benchmarkScope(numFrames, csvFile);
+
+    if (csvFile != juce::File())
+        report.write(csvFile);
+
+    return 0;
+}
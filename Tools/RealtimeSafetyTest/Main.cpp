@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 17 Oct 2026 1:39:33pm
+    Author:  Ziptye Audio
+
+    Entry point of the real-time safety test. Like the batch renderer, this
+    console target compiles the plugin's Source/ files and BinaryData together
+    with this folder. It exits with 1 if processBlock allocated, freed or
+    locked anything, or if the multiband split ran unstable.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+#include "RealtimeTrap.h"
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout << "Usage: DiamondImagerRealtimeSafetyTest [options]\n"
+                     "\n"
+                     "  --blocks=<n>          processBlock calls per layout and precision (default: 5000)\n"
+                     "  --seed=<n>            random seed (default: 1)\n"
+                     "  --abort               abort at the first violation, to catch it in a debugger\n";
+    }
+
+    juce::String getOption(const juce::ArgumentList& args, const juce::String& name, const juce::String& fallback)
+    {
+        return args.containsOption(name) ? args.getValueForOption(name) : fallback;
+    }
+
+    // Every layout isBusesLayoutSupported accepts
+    const juce::AudioChannelSet layouts[]
+    {
+        juce::AudioChannelSet::mono(),
+        juce::AudioChannelSet::stereo(),
+        juce::AudioChannelSet::create5point0(),
+        juce::AudioChannelSet::create5point1(),
+        juce::AudioChannelSet::create7point0(),
+        juce::AudioChannelSet::create7point1(),
+        juce::AudioChannelSet::create7point1point4()
+    };
+
+    const double sampleRates[] { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+
+    // Everything the message thread (or the host) may do to the processor
+    // between two blocks
+    void changeSomething(VectorScopeAudioProcessor& processor, int numChannels, juce::Random& random)
+    {
+        switch (random.nextInt(10))
+        {
+            case 0: case 1: case 2:
+            {
+                auto& parameters = processor.getParameters();
+                auto* parameter = parameters[random.nextInt(parameters.size())];
+                parameter->beginChangeGesture();
+                parameter->setValueNotifyingHost(random.nextFloat());
+                parameter->endChangeGesture();
+                break;
+            }
+
+            case 3: processor.parameterSnapshots.store(random.nextInt(ParameterSnapshots::numSlots)); break;
+            case 4: processor.parameterSnapshots.recall(random.nextInt(ParameterSnapshots::numSlots)); break;
+            case 5: processor.spectralCorrelation.setEnabled(! processor.spectralCorrelation.isEnabled()); break;
+            case 6: processor.correlationMatrix.setEnabled(! processor.correlationMatrix.isEnabled()); break;
+            case 7: processor.sharedMemoryExport.setEnabled(! processor.sharedMemoryExport.isEnabled()); break;
+
+            case 8:
+                processor.setAnalysisPair(random.nextInt(numChannels), random.nextInt(numChannels));
+                processor.resetLoudness();
+                break;
+
+            case 9:
+            default:
+                processor.setScopeWindow(random.nextFloat() * 200.0f + 5.0f);
+                processor.setScopePointBudget(256 << random.nextInt(5));
+                break;
+        }
+    }
+
+    // Noise, with the occasional loud or non-finite burst so that the output
+    // guard's paths run as well
+    template <typename SampleType>
+    void fillBlock(juce::AudioBuffer<SampleType>& buffer, juce::Random& random)
+    {
+        const int burst = random.nextInt(50);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                data[i] = static_cast<SampleType>(random.nextFloat() * 0.5f - 0.25f);
+
+            if (buffer.getNumSamples() > 0 && burst == 0)
+                data[random.nextInt(buffer.getNumSamples())] = std::numeric_limits<SampleType>::quiet_NaN();
+            else if (buffer.getNumSamples() > 0 && burst == 1)
+                juce::FloatVectorOperations::multiply(data, SampleType(16), buffer.getNumSamples());
+        }
+    }
+
+    // Every crossover at 20 kHz, 44.1 kHz: the multiband split must clamp
+    // them below Nyquist rather than run unstable sections, so ten seconds
+    // of noise peaking at -12 dBFS have to come out bounded. Returns the
+    // number of failures.
+    template <typename SampleType>
+    int checkCrossoverStability()
+    {
+        constexpr double sampleRate = 44100.0;
+        constexpr int blockSize = 512;
+        const float crossovers[MultibandWidth::maxBands - 1] { 20000.0f, 20000.0f, 20000.0f };
+        const float widths[MultibandWidth::maxBands] { 100.0f, 100.0f, 100.0f, 100.0f };
+
+        juce::Random random(1);
+        juce::AudioBuffer<SampleType> buffer(2, blockSize);
+        int failures = 0;
+
+        for (int numBands = 2; numBands <= MultibandWidth::maxBands; ++numBands)
+        {
+            MultibandWidth multiband;
+            multiband.prepare(sampleRate);
+            multiband.setParameters(numBands, crossovers, widths);
+
+            SampleType peak = 0;
+
+            for (int block = 0; block < static_cast<int>(sampleRate * 10.0) / blockSize; ++block)
+            {
+                for (int channel = 0; channel < 2; ++channel)
+                    for (int i = 0; i < blockSize; ++i)
+                        buffer.setSample(channel, i, static_cast<SampleType>(random.nextFloat() * 0.5f - 0.25f));
+
+                multiband.process(buffer.getWritePointer(0), buffer.getWritePointer(1), blockSize);
+                peak = juce::jmax(peak, static_cast<SampleType>(buffer.getMagnitude(0, blockSize)));
+            }
+
+            const bool bounded = peak < SampleType(2);
+            failures += bounded ? 0 : 1;
+
+            std::cout << "multiband " << numBands << " bands at 20 kHz   " << (std::is_same_v<SampleType, double> ? "double" : "float ")
+                      << "   peak " << juce::String(static_cast<double>(peak), 3) << (bounded ? "" : "   UNSTABLE") << "\n";
+        }
+
+        return failures;
+    }
+
+    // Returns the number of violations
+    template <typename SampleType>
+    int runLayout(const juce::AudioChannelSet& layout, int numBlocks, juce::Random& random)
+    {
+        const bool isDouble = std::is_same_v<SampleType, double>;
+        const double sampleRate = sampleRates[random.nextInt((int) std::size(sampleRates))];
+        const int maxBlockSize = 16 << random.nextInt(9); // 16 to 4096
+        const int numChannels = layout.size();
+
+        VectorScopeAudioProcessor processor;
+        VectorScopeAudioProcessor::BusesLayout buses;
+        buses.inputBuses.add(layout);
+        buses.outputBuses.add(layout);
+
+        if (! processor.setBusesLayout(buses))
+        {
+            std::cerr << layout.getDescription() << ": layout rejected\n";
+            return 1;
+        }
+
+        processor.setProcessingPrecision(isDouble ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+        processor.prepareToPlay(sampleRate, maxBlockSize);
+
+        juce::AudioBuffer<SampleType> storage(numChannels, maxBlockSize);
+        juce::MidiBuffer midi;
+        const auto before = RealtimeTrap::getViolations();
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            if (random.nextInt(4) == 0)
+                changeSomething(processor, numChannels, random);
+
+            // Any size up to the prepared maximum, now and then none at all
+            juce::AudioBuffer<SampleType> buffer(storage.getArrayOfWritePointers(), numChannels, random.nextInt(maxBlockSize + 1));
+            fillBlock(buffer, random);
+
+            {
+                RealtimeTrap::ScopedRealtimeSection realtime;
+                processor.processBlock(buffer, midi);
+            }
+
+            // Stands in for the editor draining the scope
+            processor.scopeFifo.discard(processor.scopeFifo.getNumReady());
+        }
+
+        const auto after = RealtimeTrap::getViolations();
+        const int allocations = after.allocations - before.allocations;
+        const int deallocations = after.deallocations - before.deallocations;
+        const int locks = after.locks - before.locks;
+
+        std::cout << layout.getDescription().paddedRight(' ', 20) << (isDouble ? "double" : "float ")
+                  << juce::String(sampleRate / 1000.0, 1).paddedLeft(' ', 7) << " kHz  max " << juce::String(maxBlockSize).paddedLeft(' ', 4)
+                  << "   allocations " << allocations << "  frees " << deallocations << "  locks " << locks << "\n";
+
+        processor.sharedMemoryExport.setEnabled(false);
+        processor.spectralCorrelation.setEnabled(false);
+        processor.releaseResources();
+
+        return allocations + deallocations + locks;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    const int numBlocks = juce::jmax(1, getOption(args, "--blocks", "5000").getIntValue());
+    juce::Random random(getOption(args, "--seed", "1").getLargeIntValue());
+    RealtimeTrap::setAbortOnViolation(args.containsOption("--abort"));
+
+    const int unstable = checkCrossoverStability<float>() + checkCrossoverStability<double>();
+    int violations = 0;
+
+    for (const auto& layout : layouts)
+    {
+        violations += runLayout<float>(layout, numBlocks, random);
+        violations += runLayout<double>(layout, numBlocks, random);
+    }
+
+    if (unstable > 0)
+        std::cerr << unstable << " multiband case(s) ran unstable\n";
+
+    if (violations > 0)
+        std::cerr << violations << " real-time safety violation(s) in processBlock\n";
+
+    if (unstable > 0 || violations > 0)
+        return 1;
+
+    std::cout << "processBlock stayed allocation- and lock-free, and bounded\n";
+    return 0;
+}
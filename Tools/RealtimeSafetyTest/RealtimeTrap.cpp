@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    RealtimeTrap.cpp
+    Created: 17 Oct 2026 1:39:33pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#include "RealtimeTrap.h"
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+
+ // glibc's own allocator, underneath the malloc replaced below
+ extern "C" void* __libc_malloc(size_t);
+ extern "C" void* __libc_calloc(size_t, size_t);
+ extern "C" void* __libc_realloc(void*, size_t);
+ extern "C" void __libc_free(void*);
+#endif
+
+namespace
+{
+    // Plain data only: these are touched from inside malloc, where nothing
+    // may allocate or run a constructor
+    thread_local bool inRealtimeSection = false;
+
+    std::atomic<int> numAllocations { 0 }, numDeallocations { 0 }, numLocks { 0 };
+    std::atomic<bool> abortOnViolation { false };
+
+    void check(std::atomic<int>& counter)
+    {
+        if (! inRealtimeSection)
+            return;
+
+        counter.fetch_add(1, std::memory_order_relaxed);
+
+        if (abortOnViolation.load(std::memory_order_relaxed))
+            std::abort();
+    }
+
+    void* rawAllocate(std::size_t size)
+    {
+       #if JUCE_LINUX
+        return __libc_malloc(size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+
+    void rawFree(void* block)
+    {
+       #if JUCE_LINUX
+        __libc_free(block);
+       #else
+        std::free(block);
+       #endif
+    }
+
+    void* rawAlignedAllocate(std::size_t size, std::size_t alignment)
+    {
+       #if JUCE_WINDOWS
+        return _aligned_malloc(size, alignment);
+       #else
+        void* block = nullptr;
+        return posix_memalign(&block, juce::jmax(alignment, sizeof(void*)), size) == 0 ? block : nullptr;
+       #endif
+    }
+
+    void rawAlignedFree(void* block)
+    {
+       #if JUCE_WINDOWS
+        _aligned_free(block);
+       #else
+        rawFree(block);
+       #endif
+    }
+
+    void* allocate(std::size_t size)
+    {
+        check(numAllocations);
+
+        if (auto* block = rawAllocate(size == 0 ? 1 : size))
+            return block;
+
+        throw std::bad_alloc();
+    }
+
+    void* allocate(std::size_t size, std::align_val_t alignment)
+    {
+        check(numAllocations);
+
+        if (auto* block = rawAlignedAllocate(size == 0 ? 1 : size, static_cast<std::size_t>(alignment)))
+            return block;
+
+        throw std::bad_alloc();
+    }
+
+    void deallocate(void* block)
+    {
+        if (block == nullptr)
+            return;
+
+        check(numDeallocations);
+        rawFree(block);
+    }
+
+    void deallocateAligned(void* block)
+    {
+        if (block == nullptr)
+            return;
+
+        check(numDeallocations);
+        rawAlignedFree(block);
+    }
+}
+
+//==============================================================================
+namespace RealtimeTrap
+{
+    ScopedRealtimeSection::ScopedRealtimeSection()  { inRealtimeSection = true; }
+    ScopedRealtimeSection::~ScopedRealtimeSection() { inRealtimeSection = false; }
+
+    Violations getViolations()
+    {
+        return { numAllocations.load(), numDeallocations.load(), numLocks.load() };
+    }
+
+    void setAbortOnViolation(bool shouldAbort)
+    {
+        abortOnViolation.store(shouldAbort);
+    }
+}
+
+//==============================================================================
+void* operator new(std::size_t size)                                                { return allocate(size); }
+void* operator new[](std::size_t size)                                              { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment)                    { return allocate(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment)                  { return allocate(size, alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* block) noexcept                                          { deallocate(block); }
+void operator delete[](void* block) noexcept                                        { deallocate(block); }
+void operator delete(void* block, std::size_t) noexcept                             { deallocate(block); }
+void operator delete[](void* block, std::size_t) noexcept                           { deallocate(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept                   { deallocate(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept                 { deallocate(block); }
+void operator delete(void* block, std::align_val_t) noexcept                        { deallocateAligned(block); }
+void operator delete[](void* block, std::align_val_t) noexcept                      { deallocateAligned(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept           { deallocateAligned(block); }
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept         { deallocateAligned(block); }
+
+//==============================================================================
+#if JUCE_LINUX
+// Declared noexcept to match glibc's own declarations
+extern "C"
+{
+    void* malloc(size_t size) noexcept
+    {
+        check(numAllocations);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        check(numAllocations);
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* block, size_t size) noexcept
+    {
+        check(numAllocations);
+        return __libc_realloc(block, size);
+    }
+
+    void free(void* block) noexcept
+    {
+        if (block != nullptr)
+            check(numDeallocations);
+
+        __libc_free(block);
+    }
+
+    // std::mutex and juce::CriticalSection both end up here. The real one is
+    // looked up on first use; a function-local static would need a guard
+    // that may itself lock.
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        using LockFunction = int (*)(pthread_mutex_t*);
+        static std::atomic<LockFunction> realLock { nullptr };
+
+        auto lock = realLock.load(std::memory_order_acquire);
+
+        if (lock == nullptr)
+        {
+            lock = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+            realLock.store(lock, std::memory_order_release);
+        }
+
+        check(numLocks);
+        return lock(mutex);
+    }
+}
+#endif
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    RealtimeTrap.h
+    Created: 17 Oct 2026 1:39:33pm
+    Author:  Ziptye Audio
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+// Replaces the global operator new and delete of this executable, and on
+// Linux also malloc, calloc, realloc, free and pthread_mutex_lock. Every call
+// made on a thread while it is inside a ScopedRealtimeSection is counted as a
+// violation; everywhere else they behave as usual.
+//
+// Other platforms only trap new and delete: their C allocators and locks
+// can't be replaced from inside the executable.
+namespace RealtimeTrap
+{
+    // Marks the calling thread as the audio thread for its lifetime
+    class ScopedRealtimeSection
+    {
+    public:
+        ScopedRealtimeSection();
+        ~ScopedRealtimeSection();
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeSection)
+    };
+
+    struct Violations
+    {
+        int allocations = 0, deallocations = 0, locks = 0;
+
+        int total() const { return allocations + deallocations + locks; }
+    };
+
+    // Counted since the program started, over all threads
+    Violations getViolations();
+
+    // Aborts at the first violation instead of counting it, so that a
+    // debugger stops with the offending call on the stack
+    void setAbortOnViolation(bool shouldAbort);
+}